@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include <dpch/util/EpochReclamation.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/FrozenHull.hh>
+
+namespace dpch {
+
+  /* A DynamicHull with one writer and any number of concurrent readers. The writer
+   * updates its own version of the hull, which copies the paths an update touches
+   * rather than write nodes another version refers to, and publishes a fork of it
+   * after every update: O(log n) tree nodes and O(log^2 n) segments, however large
+   * the hull. Readers query the last published version without locking, so a read
+   * that starts after an update returns sees it. Versions readers might still hold,
+   * with the nodes only they refer to and the storage the segments outgrew, are
+   * reclaimed by epoch. Every version has a live fork, so batches merge on one thread. */
+  template<typename Field> class ConcurrentDynamicHull {
+    public:
+
+      using size_t = int32_t;
+
+      class Reader;
+
+      explicit ConcurrentDynamicHull(unsigned max_readers = 128);
+      ~ConcurrentDynamicHull();
+
+      ConcurrentDynamicHull(ConcurrentDynamicHull const&) = delete;
+      ConcurrentDynamicHull& operator=(ConcurrentDynamicHull const&) = delete;
+
+      /* Writer side; calls must not overlap. */
+      void add_point(Point<Field> const&);
+      bool remove_point(Point<Field> const&);
+      size_t apply_batch(std::span< Point<Field> const > inserts,
+          std::span< Point<Field> const > deletes, unsigned threads = 1);
+
+      DynamicHull<Field> const& get_hull() const { return hull; }
+
+      /* Reader side; one Reader per thread. */
+      Reader reader() const { return Reader(*this); }
+
+    private:
+      DynamicHull<Field> hull;
+      mutable EpochDomain domain;
+      std::atomic< DynamicHull<Field> const* > published;
+
+      void publish();
+  };
+
+  template<typename Field> class ConcurrentDynamicHull<Field>::Reader {
+    public:
+      explicit Reader(ConcurrentDynamicHull const& _owner) : owner(&_owner), slot(_owner.domain) { }
+
+      /* Calls back with the current version, which stays valid until the call returns. */
+      template<typename Callback> auto read(Callback const& callback) const {
+        auto guard = slot.pin();
+        return callback(*owner->published.load());
+      }
+
+      bool point_in_polygon(Point<Field> const& point) const
+      { return read([&](DynamicHull<Field> const& hull) { return hull.point_in_polygon(point); }); }
+
+      std::optional< std::pair< Point<Field>, Point<Field> > > get_tangents(Point<Field> const& point) const
+      { return read([&](DynamicHull<Field> const& hull) { return hull.get_tangents(point); }); }
+
+      /* The current version must not be empty. */
+      std::pair< Point<Field>, Point<Field> > get_extremal_points(Point<Field> const& direction) const
+      { return read([&](DynamicHull<Field> const& hull) { return hull.get_extremal_points(direction); }); }
+
+      size_t get_hull_size() const
+      { return read([](DynamicHull<Field> const& hull) { return hull.get_hull_size(); }); }
+
+      /* A copy of the chains of the current version, for batches of queries. */
+      FrozenHull<Field> freeze() const
+      { return read([](DynamicHull<Field> const& hull) { return FrozenHull<Field>(hull); }); }
+
+    private:
+      ConcurrentDynamicHull const* owner;
+      EpochDomain::Reader slot;
+  };
+
+  template<typename Field> ConcurrentDynamicHull<Field>::ConcurrentDynamicHull(unsigned max_readers)
+    : domain(max_readers) {
+    hull.keep_outgrown(true);
+    published.store(new DynamicHull<Field>(hull.fork()));
+  }
+
+  template<typename Field> ConcurrentDynamicHull<Field>::~ConcurrentDynamicHull() {
+    delete published.load();
+  }
+
+  /* The fork shares every node with the hull, so the next update copies what it
+   * changes. Storage outgrown by the update is retired after the version it held,
+   * once readers can only find the storage that replaced it. */
+  template<typename Field> void ConcurrentDynamicHull<Field>::publish() {
+    domain.retire(published.exchange(new DynamicHull<Field>(hull.fork())));
+    for(auto& storage: hull.take_outgrown()) domain.retire(new auto(std::move(storage)));
+    domain.collect();
+  }
+
+  template<typename Field> void ConcurrentDynamicHull<Field>::add_point(Point<Field> const& point) {
+    hull.add_point(point);
+    publish();
+  }
+
+  template<typename Field> bool ConcurrentDynamicHull<Field>::remove_point(Point<Field> const& point) {
+    bool was_present = hull.remove_point(point);
+    if( was_present ) publish();
+    return was_present;
+  }
+
+  template<typename Field> ConcurrentDynamicHull<Field>::size_t ConcurrentDynamicHull<Field>::apply_batch(
+      std::span< Point<Field> const > inserts, std::span< Point<Field> const > deletes, unsigned threads) {
+    auto removed = hull.apply_batch(inserts, deletes, threads);
+    publish();
+    return removed;
+  }
+
+}; // end namespace dpch
@@ -1,14 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 #include <cstdint>
-#include <random>
 #include <vector>
 #include <iterator>
+#include <mutex>
+#include <cassert>
+#include <type_traits>
+
+#include <dpch/util/Priorities.hh>
+#include <dpch/util/Instrumentation.hh>
+#include <dpch/util/ArraySummary.hh>
 
 namespace dpch {
 
-  template<typename Element> class DynamicArray {
+  /* A sequence of elements in a treap, cut and joined by monotone predicates. Every
+   * node keeps the Summary of its subtree, see util/ArraySummary.hh; the default one
+   * summarises to nothing, takes no space and costs nothing to keep. */
+  template<typename Element, typename Summary = ArraySummary<Element>> class DynamicArray {
 
     struct TreapNode;
 
@@ -16,208 +27,513 @@ namespace dpch {
 
     using size_t = int32_t;
     using priority_t = int32_t;
+    using index_t = uint32_t;
+    using summary_t = Summary;
+
+    static constexpr index_t nil = ~index_t(0);
 
+    class Arena;
     class iterator;
     class reverse_iterator;
 
     template<typename Predicate> static void cut(const Predicate&, DynamicArray, DynamicArray&, DynamicArray&);
 
     template<typename Predicate> iterator binary_search(Predicate const&) const;
+    template<typename Predicate> size_t rank(Predicate const&) const;
+    template<typename Predicate, typename Callback> void batch_search(std::size_t, Predicate const&, Callback const&) const;
 
     static void join(DynamicArray&, DynamicArray, DynamicArray);
 
     DynamicArray();
     DynamicArray(Element const&);
+    DynamicArray(Element const&, Arena&);
+    /* With the priority ahead draws from the arena's sequence, see Arena::skip_priorities. */
+    DynamicArray(Element const&, Arena&, uint64_t ahead);
 
     inline iterator const begin() const;
     inline iterator const end() const;
 
     inline reverse_iterator const rbegin() const;
-    inline reverse_iterator const rend()  const;
+    inline reverse_iterator const rend() const;
+
+    template<typename Callback> void traverse(Callback const&) const;
+
+    size_t get_size() const;
 
-    size_t get_size();
+    /* The summary of every element, kept up to date by cut and join. */
+    summary_t get_summary() const;
+
+    /* Counts a copy of this array as one more holder of its nodes; each holder is
+     * destroyed on its own, and the nodes go when the last one is. */
+    void acquire() const;
 
     void destroy();
 
+    static Arena& default_arena();
+
     protected:
-    static std::default_random_engine engine;
-    static std::uniform_int_distribution< int32_t > rng;
+    template<typename Predicate> static void __cut(Arena&, const Predicate &, index_t, index_t&, index_t&);
 
-    template<typename Predicate> static void __cut(const Predicate &, TreapNode *, TreapNode *&, TreapNode *&);
+    static void __join(Arena&, index_t&, index_t, index_t);
 
-    static void __join(TreapNode *&, TreapNode *, TreapNode *);
+    static void __update(Arena&, index_t);
 
-    TreapNode * treap = nullptr;
+    template<typename Callback> void __traverse(Callback const&, index_t) const;
 
-    iterator _begin{nullptr}, _end{nullptr};
-    reverse_iterator _rbegin{nullptr}, _rend{nullptr};
+    template<typename Predicate, typename Callback> void __batch_search(Predicate const&, Callback const&,
+        index_t, std::size_t, std::size_t, index_t) const;
 
-    void erase(TreapNode *&);
+    Arena * arena = nullptr;
+    index_t treap = nil, _begin = nil, _rbegin = nil;
+
+    void erase(index_t&);
   };
 
-  template<typename Element> class DynamicArray<Element>::iterator {
+  /* Nodes of every array that exchanges elements through cut and join must live
+   * in one arena; they are addressed by 32 bit indices into a contiguous pool
+   * and recycled through an intrusive free list.
+   * A shared arena serialises allocation so that disjoint arrays can be worked
+   * on from several threads; it must have been reserved so that it never grows.
+   * Other threads may read nodes through a const arena while one thread works on
+   * it, as long as it neither writes nor frees those nodes meanwhile; a pool it
+   * outgrows is then kept until taken, see keep_outgrown(), for readers still
+   * looking nodes up in it.
+   * Nodes are counted by the arrays and the parents that refer to them. Arrays may
+   * share nodes, see acquire(): cut and join copy a node referred to more than once
+   * before relinking it, and a node is freed when the last reference to it goes.
+   * Each arena draws the priorities of its nodes from its own sequence, under the
+   * lock when shared. */
+  template<typename Element, typename Summary> class DynamicArray<Element, Summary>::Arena {
+    public:
+      /* Nodes for the thread working on the arena, and for readers through a const
+       * arena, which finds the pool that thread last grew into. */
+      inline TreapNode& operator[](index_t index) { return nodes[index]; }
+      inline TreapNode const& operator[](index_t index) const { return base.load(std::memory_order_acquire)[index]; }
+
+      index_t allocate(Element const&);
+      /* A node with the priority ahead draws from now, drawn later by skip_priorities:
+       * threads filling a shared arena then give equal seeds equal shapes still. */
+      index_t allocate(Element const&, uint64_t ahead);
+      void skip_priorities(uint64_t count) { priorities.skip(count); }
+      void release(index_t);
+
+      /* Index of a node the caller may write, copying it if it is shared. */
+      index_t own(index_t);
+      inline void acquire(index_t index) { if( index != nil ) nodes[index].refs++; }
+      /* Drops a reference to a node; true if it was the last one. */
+      inline bool release_ref(index_t index) { return --nodes[index].refs == 0; }
+
+      /* Copies made by own() so far, for arrays to tell whether their ends moved. */
+      uint64_t get_copies() const { return copies; }
+
+      void seed(uint64_t _seed) { priorities.seed(_seed); }
+      void reserve(size_t count) { if( nodes.size() + count > nodes.capacity() ) grow(nodes.size() + count); }
+      void share(bool _shared) { shared = _shared; }
+      size_t get_size() const { return nodes.size() - free_nodes; }
+
+      /* Whether to keep the pools the arena outgrows rather than free them, until
+       * take_outgrown() hands them over to be freed once no reader can see them. */
+      void keep_outgrown(bool _keep) { keep = _keep; }
+      std::vector< std::vector< TreapNode > > take_outgrown() { return std::exchange(outgrown, {}); }
+
+    private:
+      std::vector< TreapNode > nodes;
+      std::atomic< TreapNode* > base = nullptr; // nodes.data(), for readers on other threads
+      std::vector< std::vector< TreapNode > > outgrown;
+      bool keep = false;
+      index_t free_list = nil;
+      size_t free_nodes = 0;
+      bool shared = false;
+      uint64_t copies = 0;
+      Priorities priorities;
+      std::mutex mutex;
+
+      index_t allocate(TreapNode const&);
+      index_t __allocate(TreapNode);
+      void grow(std::size_t);
+  };
+
+  /* A position in an array. Nodes have no links to their neighbours, which could not
+   * be shared between arrays, so an iterator that is stepped keeps the ancestors of its
+   * node: the first step looks its position up from the root in O(log n), and the next
+   * ones climb and descend from there, amortized O(1) each along a walk. traverse()
+   * walks a whole array without them. Iterators handed to predicates and callbacks
+   * know no position, and cannot be stepped. */
+  template<typename Element, typename Summary> class DynamicArray<Element, Summary>::iterator {
     public:
       using iterator_category = std::bidirectional_iterator_tag;
+      using difference_type = std::ptrdiff_t;
       using value_type = Element;
-      using pointer    = Element*;
-      using reference  = Element&;
+      using pointer    = Element const*;
+      using reference  = Element const&;
 
-      iterator(DynamicArray<Element>::TreapNode*_ptr) : ptr(_ptr) {}
+      iterator(Arena const*_arena, index_t _index) : arena(_arena), index(_index) {}
+      iterator(Arena const*_arena, index_t _root, index_t _index, size_t _position)
+        : arena(_arena), index(_index), root(_root), position(_position) {}
 
-      reference operator*() const { return ptr->element; }
-      pointer operator->() const { return &(ptr->element); }
+      reference operator*() const { return (*arena)[index].element; }
+      pointer operator->() const { return &((*arena)[index].element); }
 
-      iterator& operator++() { ptr = ptr->next; return *this; }
-      // iterator  operator++(int) { return ptr->next; }
-      iterator& operator--() { ptr = ptr->prev; return *this; }
-      // iterator  operator--(int) { return ptr->prev; }
+      iterator& operator++() { return step(&TreapNode::right, &TreapNode::left, +1); }
+      iterator& operator--() { return step(&TreapNode::left, &TreapNode::right, -1); }
 
-      friend bool operator== (iterator const& a, iterator const& b) { return a.ptr == b.ptr; }
-      friend bool operator!= (iterator const& a, iterator const& b) { return a.ptr != b.ptr; }
+      friend bool operator== (iterator const& a, iterator const& b) { return a.index == b.index; }
+      friend bool operator!= (iterator const& a, iterator const& b) { return a.index != b.index; }
 
     private:
+      friend class DynamicArray::reverse_iterator;
+      static constexpr size_t unknown = INT32_MIN;
+
+      /* Moves to the next node on the side of forward, the other side being backward. */
+      iterator& step(index_t TreapNode::* forward, index_t TreapNode::* backward, size_t delta) {
+        assert( position != unknown );
+        position += delta;
+        if( index == nil or (path.empty() and index != root) ) return descend();
+        auto const& nodes = *arena;
+        if( nodes[index].*forward != nil ) {
+          path.push_back(index), index = nodes[index].*forward;
+          while( nodes[index].*backward != nil ) path.push_back(index), index = nodes[index].*backward;
+          return *this;
+        }
+        while( true ) {
+          if( path.empty() ) return index = nil, *this;
+          index_t parent = path.back();
+          path.pop_back();
+          if( nodes[parent].*backward == index ) return index = parent, *this;
+          index = parent;
+        }
+      }
+
+      /* Looks the position up from the root, keeping the ancestors on the way. */
+      iterator& descend() {
+        auto const& nodes = *arena;
+        path.clear(), index = nil;
+        if( root == nil or position < 0 or position >= nodes[root].size ) return *this;
+        size_t rest = position;
+        for(index_t ptr = root; ; ) {
+          auto const& node = nodes[ptr];
+          size_t left = node.left == nil ? 0 : nodes[node.left].size;
+          if( rest == left ) return index = ptr, *this;
+          path.push_back(ptr);
+          if( rest < left ) ptr = node.left;
+          else rest -= left + 1, ptr = node.right;
+        }
+      }
 
-      TreapNode * ptr;
+      Arena const* arena;
+      index_t index, root = nil;
+      size_t position = unknown;
+      std::vector< index_t > path; // ancestors of index, once stepped
   };
 
-  template<typename Element> class DynamicArray<Element>::reverse_iterator {
+  template<typename Element, typename Summary> class DynamicArray<Element, Summary>::reverse_iterator {
     public:
       using iterator_category = std::bidirectional_iterator_tag;
+      using difference_type = std::ptrdiff_t;
       using value_type = Element;
-      using pointer    = Element*;
-      using reference  = Element&;
+      using pointer    = Element const*;
+      using reference  = Element const&;
 
-      reverse_iterator(DynamicArray<Element>::TreapNode*_ptr) : ptr(_ptr) {}
+      reverse_iterator(Arena const*_arena, index_t _root, index_t _index, size_t _position)
+        : forward(_arena, _root, _index, _position) {}
 
-      reference operator*() const { return ptr->element; }
-      pointer operator->() const { return &(ptr->element); }
+      reference operator*() const { return *forward; }
+      pointer operator->() const { return forward.operator->(); }
 
-      reverse_iterator& operator++() { ptr = ptr->prev; return *this; }
-      // iterator  operator++(int) { return ptr->next; }
-      reverse_iterator& operator--() { ptr = ptr->next; return *this; }
-      // iterator  operator--(int) { return ptr->prev; }
+      reverse_iterator& operator++() { --forward; return *this; }
+      reverse_iterator& operator--() { ++forward; return *this; }
 
-      friend bool operator== (reverse_iterator const& a, reverse_iterator const& b) { return a.ptr == b.ptr; }
-      friend bool operator!= (reverse_iterator const& a, reverse_iterator const& b) { return a.ptr != b.ptr; }
+      friend bool operator== (reverse_iterator const& a, reverse_iterator const& b) { return a.forward == b.forward; }
+      friend bool operator!= (reverse_iterator const& a, reverse_iterator const& b) { return a.forward != b.forward; }
 
     private:
-
-      TreapNode * ptr;
+      iterator forward;
   };
 
-  template<typename Element> std::default_random_engine DynamicArray<Element>::engine;
-  template<typename Element> std::uniform_int_distribution< int32_t > DynamicArray<Element>::rng;
-
-  template<typename Element> inline DynamicArray<Element>::reverse_iterator const DynamicArray<Element>::rbegin() const
-  { return _rbegin; }
+  template<typename Element, typename Summary> inline DynamicArray<Element, Summary>::reverse_iterator const DynamicArray<Element, Summary>::rbegin() const
+  { return reverse_iterator(arena, treap, _rbegin, get_size() - 1); }
 
-  template<typename Element> DynamicArray<Element>::reverse_iterator const DynamicArray<Element>::rend() const
-  { return _rend; }
+  template<typename Element, typename Summary> inline DynamicArray<Element, Summary>::reverse_iterator const DynamicArray<Element, Summary>::rend() const
+  { return reverse_iterator(arena, treap, nil, -1); }
 
-  template<typename Element> inline DynamicArray<Element>::iterator const DynamicArray<Element>::begin() const
-  { return _begin; }
+  template<typename Element, typename Summary> inline DynamicArray<Element, Summary>::iterator const DynamicArray<Element, Summary>::begin() const
+  { return iterator(arena, treap, _begin, 0); }
 
-  template<typename Element> inline DynamicArray<Element>::iterator const DynamicArray<Element>::end() const
-  { return _end; }
+  template<typename Element, typename Summary> inline DynamicArray<Element, Summary>::iterator const DynamicArray<Element, Summary>::end() const
+  { return iterator(arena, treap, nil, get_size()); }
 
-  template<typename Element> struct DynamicArray<Element>::TreapNode {
-    DynamicArray<Element>::priority_t priority;
-    TreapNode *left = nullptr, *right = nullptr, *prev = nullptr, *next = nullptr;
+  template<typename Element, typename Summary> struct DynamicArray<Element, Summary>::TreapNode {
+    DynamicArray<Element, Summary>::priority_t priority;
+    DynamicArray<Element, Summary>::size_t size = 1;
+    index_t left = nil, right = nil;
+    size_t refs = 1;
     Element element;
-    DynamicArray<Element>::size_t size;
-    TreapNode(Element const &_element):
-      priority(rng(engine)), element(_element) { }
+    [[no_unique_address]] summary_t summary;
+    TreapNode(Element const &_element, priority_t _priority):
+      priority(_priority), element(_element), summary(_element) { }
   };
 
-  template<typename Element> DynamicArray<Element>::DynamicArray() { }
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::index_t DynamicArray<Element, Summary>::Arena::allocate(Element const& element) {
+    if( not shared ) return __allocate(TreapNode(element, priorities()));
+    std::lock_guard<std::mutex> lock(mutex);
+    assert( free_list != nil or nodes.size() < nodes.capacity() );
+    return __allocate(TreapNode(element, priorities()));
+  }
+
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::index_t DynamicArray<Element, Summary>::Arena::allocate(Element const& element, uint64_t ahead) {
+    if( not shared ) return __allocate(TreapNode(element, priorities.peek(ahead)));
+    std::lock_guard<std::mutex> lock(mutex);
+    assert( free_list != nil or nodes.size() < nodes.capacity() );
+    return __allocate(TreapNode(element, priorities.peek(ahead)));
+  }
+
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::index_t DynamicArray<Element, Summary>::Arena::allocate(TreapNode const& node) {
+    if( not shared ) return __allocate(node);
+    std::lock_guard<std::mutex> lock(mutex);
+    assert( free_list != nil or nodes.size() < nodes.capacity() );
+    return __allocate(node);
+  }
 
-  template<typename Element>
-    DynamicArray<Element>::DynamicArray(Element const& element) { 
-      treap = new DynamicArray<Element>::TreapNode(element); 
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::index_t DynamicArray<Element, Summary>::Arena::__allocate(TreapNode node) {
+    DPCH_COUNT(allocated);
+    node.refs = 1;
+    if( free_list == nil ) {
+      if( nodes.size() == nodes.capacity() ) grow(std::max< std::size_t >(64, 2 * nodes.capacity()));
+      nodes.push_back(node);
+      return index_t(nodes.size() - 1);
+    }
+    index_t index = free_list;
+    free_list = nodes[index].left, free_nodes--;
+    nodes[index] = node;
+    return index;
+  }
+
+  /* Copies the nodes over to a larger pool rather than let the vector move them, so
+   * that the old pool can be kept for readers. */
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::Arena::grow(std::size_t capacity) {
+    std::vector< TreapNode > grown;
+    grown.reserve(capacity);
+    grown.assign(nodes.begin(), nodes.end());
+    std::swap(nodes, grown);
+    base.store(nodes.data(), std::memory_order_release);
+    if( keep ) outgrown.push_back(std::move(grown));
+  }
+
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::Arena::release(index_t index) {
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if( shared ) lock.lock();
+    DPCH_COUNT(freed);
+    nodes[index].left = free_list, free_list = index, free_nodes++;
+  }
+
+  /* The copy refers to the children of the node, which is left to its other holders. */
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::index_t DynamicArray<Element, Summary>::Arena::own(index_t index) {
+    if( nodes[index].refs == 1 ) return index;
+    TreapNode copy = nodes[index];
+    nodes[index].refs--, copies++;
+    acquire(copy.left), acquire(copy.right);
+    return allocate(copy);
+  }
+
+  /* One per thread, so that arrays made without an arena never share one across threads. */
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::Arena& DynamicArray<Element, Summary>::default_arena() {
+    thread_local Arena arena;
+    return arena;
+  }
+
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::DynamicArray() { }
+
+  template<typename Element, typename Summary>
+    DynamicArray<Element, Summary>::DynamicArray(Element const& element) : DynamicArray(element, default_arena()) { }
+
+  template<typename Element, typename Summary>
+    DynamicArray<Element, Summary>::DynamicArray(Element const& element, Arena& _arena) : arena(&_arena) {
+      treap = arena->allocate(element);
       _begin = treap, _rbegin = treap;
-      treap->size = 1;
     }
 
-  template<typename Element> void DynamicArray<Element>::destroy() { erase(treap); }
+  template<typename Element, typename Summary>
+    DynamicArray<Element, Summary>::DynamicArray(Element const& element, Arena& _arena, uint64_t ahead) : arena(&_arena) {
+      treap = arena->allocate(element, ahead);
+      _begin = treap, _rbegin = treap;
+    }
 
-  template<typename Element> void DynamicArray<Element>::erase(TreapNode *& root) {
-    if( root == nullptr ) return;
-    erase(root->left), erase(root->right);
-    delete root, root = nullptr;
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::acquire() const {
+    if( treap != nil ) arena->acquire(treap);
   }
 
-  template<typename Element> template<typename Predicate> void DynamicArray<Element>::__cut(
-      Predicate const&predicate, TreapNode *treap_root, TreapNode *&left_root, TreapNode *&right_root) {
-    if( treap_root == nullptr )
-      return void(left_root = right_root = nullptr);
-    if( predicate(iterator(treap_root)) ) {
-      __cut(predicate, treap_root->left, left_root, treap_root->left);
-      right_root = treap_root;
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::destroy() { erase(treap); }
+
+  /* Nodes still referred to elsewhere, and so everything below them, are kept. */
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::erase(index_t & root) {
+    if( root == nil ) return;
+    if( not arena->release_ref(root) ) return void(root = nil);
+    erase((*arena)[root].left), erase((*arena)[root].right);
+    arena->release(root), root = nil;
+  }
+
+  template<typename Element, typename Summary> template<typename Predicate> void DynamicArray<Element, Summary>::__cut(Arena& nodes,
+      Predicate const&predicate, index_t treap_root, index_t &left_root, index_t &right_root) {
+    DPCH_RECURSION(cuts, cut_depth);
+    if( treap_root == nil )
+      return void(left_root = right_root = nil);
+    // copying may grow the pool, so nodes are not held by reference across the recursion
+    index_t root = nodes.own(treap_root), child;
+    if( predicate(iterator(&nodes, root)) ) {
+      __cut(nodes, predicate, nodes[root].left, left_root, child);
+      nodes[root].left = child, right_root = root;
     } else {
-      __cut(predicate, treap_root->right, treap_root->right, right_root);
-      left_root = treap_root;
+      __cut(nodes, predicate, nodes[root].right, child, right_root);
+      nodes[root].right = child, left_root = root;
     }
-    treap_root->size = 1 + (treap_root->left == nullptr ? 0 : treap_root->left->size) +
-      (treap_root->right == nullptr ? 0 : treap_root->right->size);
+    __update(nodes, root);
   }
 
-  template<typename Element> template<typename Predicate> void DynamicArray<Element>::cut(
+  template<typename Element, typename Summary> template<typename Predicate> void DynamicArray<Element, Summary>::cut(
       const Predicate &predicate, DynamicArray from, DynamicArray &left, DynamicArray &right) {
 
-    __cut(predicate, from.treap, left.treap, right.treap);
+    left.arena = right.arena = from.arena;
+    left._begin = right._begin = nil;
+    left._rbegin = right._rbegin = nil;
+    if( from.treap == nil ) return void(left.treap = right.treap = nil);
 
-    // update begin, _rbegin, prev, next
-    left._begin = right._begin = nullptr;
-    left._rbegin = right._rbegin = nullptr;
+    auto &nodes = *from.arena;
+    __cut(nodes, predicate, from.treap, left.treap, right.treap);
+
+    // update begin, _rbegin
     auto ll = left.treap, lr = ll, rl = right.treap, rr = rl;
-    while( ll != nullptr and ll->left != nullptr )  ll = ll->left;
-    while( lr != nullptr and lr->right != nullptr ) lr = lr->right;
-    while( rl != nullptr and rl->left != nullptr )  rl = rl->left;
-    while( rr != nullptr and rr->right != nullptr ) rr = rr->right;
-    if( rl != nullptr ) rl->prev = nullptr;
-    if( lr != nullptr ) lr->next = nullptr;
+    while( ll != nil and nodes[ll].left != nil )  ll = nodes[ll].left;
+    while( lr != nil and nodes[lr].right != nil ) lr = nodes[lr].right;
+    while( rl != nil and nodes[rl].left != nil )  rl = nodes[rl].left;
+    while( rr != nil and nodes[rr].right != nil ) rr = nodes[rr].right;
     left._begin = ll, left._rbegin = lr, right._begin = rl, right._rbegin = rr;
   }
 
 
-  template<typename Element> void DynamicArray<Element>::__join(TreapNode *&root, TreapNode *left_root, TreapNode *right_root) {
-    if( left_root == nullptr or right_root == nullptr )
-      return void(root = ( left_root == nullptr ? right_root : left_root ));
-    if( left_root->priority < right_root->priority ) {
-      __join(right_root->left, left_root, right_root->left);
-      root = right_root;
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::__join(Arena& nodes,
+      index_t &root, index_t left_root, index_t right_root) {
+    DPCH_RECURSION(joins, join_depth);
+    if( left_root == nil or right_root == nil )
+      return void(root = ( left_root == nil ? right_root : left_root ));
+    index_t top, child;
+    if( nodes[left_root].priority < nodes[right_root].priority ) {
+      top = nodes.own(right_root);
+      __join(nodes, child, left_root, nodes[top].left);
+      nodes[top].left = child;
     } else {
-      __join(left_root->right, left_root->right, right_root);
-      root = left_root;
+      top = nodes.own(left_root);
+      __join(nodes, child, nodes[top].right, right_root);
+      nodes[top].right = child;
     }
-    root->size = 1 + (root->left == nullptr ? 0 : root->left->size) +
-      (root->right == nullptr ? 0 : root->right->size);
+    root = top;
+    __update(nodes, root);
   }
 
-  template<typename Element> void DynamicArray<Element>::join(DynamicArray &to, DynamicArray left, DynamicArray right) {
-    auto lt = left.treap, rt = right.treap;
-    if( lt != nullptr and rt != nullptr ) {
-      while(lt->right != nullptr) lt = lt->right;
-      while(rt->left  != nullptr) rt = rt->left;
-      lt->next = rt, rt->prev = lt;
-    }
-    to._begin = left.treap != nullptr ? left._begin : right._begin;
-    to._rbegin = right.treap != nullptr ? right._rbegin : left._rbegin;
-    __join(to.treap, left.treap, right.treap);
+  /* Size and summary of a node from those of its children. */
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::__update(Arena& nodes, index_t root) {
+    auto &_root = nodes[root];
+    _root.size = 1 + (_root.left == nil ? 0 : nodes[_root.left].size) +
+      (_root.right == nil ? 0 : nodes[_root.right].size);
+    if constexpr ( std::is_empty_v<summary_t> ) return;
+    summary_t summary = _root.left == nil ? summary_t() : nodes[_root.left].summary;
+    summary.add(summary_t(_root.element));
+    if( _root.right != nil ) summary.add(nodes[_root.right].summary);
+    _root.summary = summary;
   }
 
-  template<typename Element> template<typename Predicate> DynamicArray<Element>::iterator 
-    DynamicArray<Element>::binary_search(Predicate const& predicate) const {
-      DynamicArray<Element>::TreapNode *ptr = treap, *ret = nullptr;
-      while(ptr != nullptr) {
-        if( predicate(iterator(ptr)) ) ret = ptr, ptr = ptr->left;
-        else ptr = ptr->right;
+  template<typename Element, typename Summary> void DynamicArray<Element, Summary>::join(DynamicArray &to, DynamicArray left, DynamicArray right) {
+    to.arena = left.treap != nil ? left.arena : right.arena;
+    if( to.arena == nullptr ) return void(to.treap = to._begin = to._rbegin = nil);
+    auto &nodes = *to.arena;
+    to._begin = left.treap != nil ? left._begin : right._begin;
+    to._rbegin = right.treap != nil ? right._rbegin : left._rbegin;
+    auto copies = nodes.get_copies();
+    __join(nodes, to.treap, left.treap, right.treap);
+    if( nodes.get_copies() == copies ) return;
+    // the ends may have been copied, and the originals belong to other arrays now
+    auto first = to.treap, last = to.treap;
+    while( nodes[first].left != nil ) first = nodes[first].left;
+    while( nodes[last].right != nil ) last = nodes[last].right;
+    to._begin = first, to._rbegin = last;
+  }
+
+  template<typename Element, typename Summary> template<typename Predicate> DynamicArray<Element, Summary>::iterator
+    DynamicArray<Element, Summary>::binary_search(Predicate const& predicate) const {
+      if( treap == nil ) return end();
+      auto const& nodes = *arena;
+      index_t ptr = treap, ret = nil;
+      size_t count = 0, position = get_size();
+      while(ptr != nil) {
+        auto const& node = nodes[ptr];
+        size_t before = count + (node.left == nil ? 0 : nodes[node.left].size);
+        if( predicate(iterator(arena, ptr)) ) ret = ptr, position = before, ptr = node.left;
+        else count = before + 1, ptr = node.right;
       }
-      return iterator(ret);
+      return iterator(arena, treap, ret, position);
     }
 
-  template<typename Element> DynamicArray<Element>::size_t DynamicArray<Element>::get_size() {
-    return (treap == nullptr ? 0 : treap->size);
+  /* Number of elements before the first one satisfying a monotone predicate. */
+  template<typename Element, typename Summary> template<typename Predicate> DynamicArray<Element, Summary>::size_t
+    DynamicArray<Element, Summary>::rank(Predicate const& predicate) const {
+      if( treap == nil ) return 0;
+      auto const& nodes = *arena;
+      size_t count = 0;
+      for(index_t ptr = treap; ptr != nil; ) {
+        auto const& node = nodes[ptr];
+        if( predicate(iterator(arena, ptr)) ) ptr = node.left;
+        else count += 1 + (node.left == nil ? 0 : nodes[node.left].size), ptr = node.right;
+      }
+      return count;
+    }
+
+  /* binary_search for queries 0 to n - 1 at once, with predicate(iterator, query) monotone
+   * along the array for each query, and the element it finds moving right from one
+   * query to the next; callback(query, iterator) gets each result. Every node on the
+   * union of the search paths is visited once, and splits the queries that reach it
+   * by a binary search on them. */
+  template<typename Element, typename Summary> template<typename Predicate, typename Callback>
+    void DynamicArray<Element, Summary>::batch_search(std::size_t n, Predicate const& predicate, Callback const& callback) const {
+      __batch_search(predicate, callback, treap, 0, n, nil);
+    }
+
+  template<typename Element, typename Summary> template<typename Predicate, typename Callback>
+    void DynamicArray<Element, Summary>::__batch_search(Predicate const& predicate, Callback const& callback,
+        index_t ptr, std::size_t first, std::size_t last, index_t ret) const {
+      if( first == last ) return;
+      if( ptr == nil ) {
+        for(auto query = first; query < last; query++) callback(query, iterator(arena, ret));
+        return;
+      }
+      auto lo = first, hi = last;
+      while( lo < hi ) {
+        auto middle = lo + (hi - lo) / 2;
+        if( predicate(iterator(arena, ptr), middle) ) lo = middle + 1;
+        else hi = middle;
+      }
+      auto const& node = std::as_const(*arena)[ptr];
+      __batch_search(predicate, callback, node.left, first, lo, ptr);
+      __batch_search(predicate, callback, node.right, lo, last, ret);
+    }
+
+  template<typename Element, typename Summary> template<typename Callback>
+    void DynamicArray<Element, Summary>::traverse(Callback const& callback) const {
+      if( treap != nil ) __traverse(callback, treap);
+    }
+
+  template<typename Element, typename Summary> template<typename Callback>
+    void DynamicArray<Element, Summary>::__traverse(Callback const& callback, index_t root) const {
+      auto const& node = std::as_const(*arena)[root];
+      if( node.left != nil ) __traverse(callback, node.left);
+      callback(node.element);
+      if( node.right != nil ) __traverse(callback, node.right);
+    }
+
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::size_t DynamicArray<Element, Summary>::get_size() const {
+    return (treap == nil ? 0 : std::as_const(*arena)[treap].size);
+  }
+
+  template<typename Element, typename Summary> DynamicArray<Element, Summary>::summary_t DynamicArray<Element, Summary>::get_summary() const {
+    return (treap == nil ? summary_t() : std::as_const(*arena)[treap].summary);
   }
 
 }; // end namespace dpch
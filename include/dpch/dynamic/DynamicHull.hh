@@ -4,186 +4,433 @@
 #include <vector>
 #include <iostream>
 #include <cassert>
-
+#include <algorithm>
+#include <span>
+#include <memory>
+#include <type_traits>
+
+#include <dpch/util/ForkJoin.hh>
+#include <dpch/util/Priorities.hh>
+#include <dpch/util/Instrumentation.hh>
 #include <dpch/dynamic/DynamicArray.hh>
 #include <dpch/dynamic/MergeableLowerHull.hh>
 #include <dpch/dynamic/MergeableUpperHull.hh>
+#include <dpch/dynamic/HullQueries.hh>
 
 namespace dpch {
 
-  template<typename Field> class DynamicHull {
+  /* Versions made by fork() share every node they have in common; updates copy the
+   * nodes on the paths they touch, O(log n) tree nodes and O(log^2 n) segments,
+   * and leave the nodes of other versions alone. Tree and segment nodes alike are
+   * counted, and freed when the last version that refers to them lets go. Versions
+   * that share nodes must not be updated concurrently. The chains keep Summary, see
+   * util/ArraySummary.hh: area(), perimeter() and centroid() need ChainSummary<Field>,
+   * which the default summary leaves out so that hulls without them do not pay for it. */
+  template<typename Field, typename Summary = ArraySummary< LineSegment<Field> >> class DynamicHull {
 
     public :
 
       using size_t = int32_t;
       using priority_t = int32_t;
 
-      using lower_hull_t = MergeableLowerHull<Field>;
-      using upper_hull_t = MergeableUpperHull<Field>;
+      using lower_hull_t = MergeableLowerHull<Field, Summary>;
+      using upper_hull_t = MergeableUpperHull<Field, Summary>;
+
+      DynamicHull() = default;
+      template<typename Iterator> DynamicHull(Iterator, Iterator, bool sorted = false, unsigned threads = 1);
+      DynamicHull(DynamicHull const&) = delete;
+      DynamicHull& operator=(DynamicHull const&) = delete;
+      DynamicHull(DynamicHull&&);
+      DynamicHull& operator=(DynamicHull&&);
+      ~DynamicHull();
+
+      /* A new version holding the same points, in constant time. */
+      DynamicHull fork();
+
+      /* Restarts the priority sequences, so that equal seeds and equal updates
+       * give equal trees. */
+      void seed(uint64_t);
+
+      template<typename Iterator> void assign(Iterator, Iterator, bool sorted = false, unsigned threads = 1);
+
+      size_t apply_batch(std::span< Point<Field> const > inserts,
+          std::span< Point<Field> const > deletes, unsigned threads = 1);
 
       void add_point(Point<Field> const&);
       bool remove_point(Point<Field> const&);
 
-      bool point_in_polygon(Point<Field> const&);
+      bool point_in_polygon(Point<Field> const&) const;
 
       std::optional< std::pair< Point<Field>, Point<Field> > >
         get_tangents (Point<Field> const&) const;
 
+      /* The hull must not be empty. */
       std::pair< Point<Field>, Point<Field> >
         get_extremal_points(Point<Field> const&) const;
 
+      /* get_extremal_points for every direction; enough of them are sorted by angle and
+       * searched for together, see __get_extremal_points_batch. */
+      std::vector< std::pair< Point<Field>, Point<Field> > >
+        get_extremal_points_batch(std::span< Point<Field> const >) const;
+
       template<typename Callback> void traverse_lower_hull(Callback const&) const;
       template<typename Callback> void traverse_upper_hull(Callback const&) const;
 
+      /* The chains themselves, for structures that combine several hulls. */
+      lower_hull_t const& get_lower_hull() const;
+      upper_hull_t const& get_upper_hull() const;
+
       size_t get_lower_hull_size() const;
       size_t get_upper_hull_size() const;
       size_t get_hull_size() const;
       size_t get_num_points() const;
 
+      /* Segments held for this hull and the forks it shares nodes with. */
+      size_t get_num_segments() const { return arena->get_size(); }
+
+      /* For forks read from other threads while this hull is updated: the storage of
+       * segments is then kept when outgrown, until taken to be freed once no reader
+       * can be looking at it. */
+      void keep_outgrown(bool keep) { arena->keep_outgrown(keep); }
+      auto take_outgrown() { return arena->take_outgrown(); }
+
+      /* Measures of a nonempty hull in constant time, from the summaries the chains
+       * keep through every update; see HullMeasures. Only for Summary = ChainSummary<Field>. */
+      double area() const { return measures().area(); }
+      double perimeter() const { return measures().perimeter(); }
+      Point<double> centroid() const { return measures().centroid(); }
+
       template<typename Callback> void traverse_hull(Callback const&) const;
       template<typename Callback> void traverse_set (Callback const&) const;
 
+      /* Work done by updates, when built with DPCH_INSTRUMENT; see util/Instrumentation.hh. */
+      HullStats const& get_stats() const { return stats; }
+      void reset_stats() { stats = HullStats(); }
+      void set_trace(trace_callback_t _trace) { trace = std::move(_trace); }
+
     private:
-      static std::default_random_engine engine;
-      static std::uniform_int_distribution< int32_t > rng;
+      HullMeasures<Field> measures() const;
 
+      /* Nodes are not polymorphic: a leaf is tagged by a negative priority, and
+       * the bounds and hulls every node needs are stored inline in the base.
+       * Nodes are counted by the versions and the parents that refer to them,
+       * and one referred to more than once is copied before it is written. */
       template<typename TotalOrder> class TreapNode {
+        protected:
+          DynamicHull::priority_t _priority;
+          size_t _refs = 1;
+          TotalOrder _lo, _hi;
+          lower_hull_t _lower_hull;
+          upper_hull_t _upper_hull;
+          TreapNode(DynamicHull::priority_t priority) : _priority(priority) { DPCH_COUNT(allocated); }
+          TreapNode(DynamicHull::priority_t priority, TotalOrder const& point)
+            : _priority(priority), _lo(point), _hi(point) { DPCH_COUNT(allocated); }
+          TreapNode(TreapNode const& node) : _priority(node._priority), _lo(node._lo), _hi(node._hi),
+            _lower_hull(node._lower_hull), _upper_hull(node._upper_hull) {
+            DPCH_COUNT(allocated);
+            _lower_hull.acquire(), _upper_hull.acquire();
+          }
+          ~TreapNode() { DPCH_COUNT(freed); }
         public:
-          inline virtual lower_hull_t& lower_hull() = 0;
-          inline virtual upper_hull_t& upper_hull() = 0;
-          inline virtual bool is_leaf() const = 0;
-          inline virtual DynamicHull::priority_t priority() const = 0;
-          inline virtual TotalOrder lo() const = 0;
-          inline virtual TotalOrder hi() const = 0;
+          inline void acquire() { _refs++; }
+          inline bool release() { return --_refs == 0; }
+          inline bool is_shared() const { return _refs > 1; }
+          inline lower_hull_t& lower_hull() { return _lower_hull; }
+          inline upper_hull_t& upper_hull() { return _upper_hull; }
+          inline bool is_leaf() const { return _priority < 0; }
+          inline DynamicHull::priority_t priority() const { return _priority; }
+          inline TotalOrder const& lo() const { return _lo; }
+          inline TotalOrder const& hi() const { return _hi; }
       };
 
 
+      using arena_t = typename DynamicArray<LineSegment<Field>, Summary>::Arena;
+
+      /* Storage for the segments of every hull in the tree, shared by all forks;
+       * a version is alone in its arena once all its forks are gone. */
+      std::shared_ptr< arena_t > arena = std::make_shared< arena_t >();
+
+      /* Priorities of branches; those of segments come from the arena. */
+      Priorities priorities;
+
       size_t _leaves = 0;
       TreapNode < Point<Field> > * master_root = nullptr;
 
+      /* Set while a batch is applied: branches are split at most once on the way
+       * down, and merged once at the end instead of after every update. */
+      bool deferred = false;
+
+      HullStats stats;
+      trace_callback_t trace;
+
       template<typename Callback> void __traverse_set (Callback const&, TreapNode<Point<Field>>*) const;
 
       template<typename TotalOrder> class TreapLeaf : public TreapNode<TotalOrder> {
-        TotalOrder point;
-        lower_hull_t _lower_hull;
-        upper_hull_t _upper_hull;
         public:
-        inline bool is_leaf() const { return true; }
-        inline DynamicHull::priority_t priority() const { return -1; }
-        inline TotalOrder lo() const { return point; }
-        inline TotalOrder hi() const { return point; }
-        void set_point(TotalOrder const& _point) { point = _point; }
-
-        inline lower_hull_t& lower_hull() { return _lower_hull; }
-        inline upper_hull_t& upper_hull() { return _upper_hull; }
-
-        TreapLeaf(const TotalOrder& _point) : point(_point) { 
-          _lower_hull = MergeableLowerHull<Field>(LineSegment<Field>{point, point});
-          _upper_hull = MergeableUpperHull<Field>(LineSegment<Field>{point, point});
+        TreapLeaf(TreapLeaf const&) = default;
+        TreapLeaf(const TotalOrder& point, arena_t& arena) : TreapNode<TotalOrder>(-1, point) {
+          this->_lower_hull = lower_hull_t(LineSegment<Field>{point, point}, arena);
+          this->_upper_hull = upper_hull_t(LineSegment<Field>{point, point}, arena);
+        }
+        /* The index-th of leaves built at once, with the arena's next priorities by index. */
+        TreapLeaf(const TotalOrder& point, arena_t& arena, uint64_t index) : TreapNode<TotalOrder>(-1, point) {
+          this->_lower_hull = lower_hull_t(LineSegment<Field>{point, point}, arena, 2 * index);
+          this->_upper_hull = upper_hull_t(LineSegment<Field>{point, point}, arena, 2 * index + 1);
         }
         ~TreapLeaf() {
-          _lower_hull.destroy(), _upper_hull.destroy();
+          this->_lower_hull.destroy(), this->_upper_hull.destroy();
         }
       };
 
       template<typename TotalOrder> class TreapBranch : public TreapNode<TotalOrder> {
-        DynamicHull::priority_t _priority = rng(engine);
-        TotalOrder _lo, _hi;
-        lower_hull_t _lower_hull, lower_left_residue, lower_right_residue;
-        upper_hull_t _upper_hull, upper_left_residue, upper_right_residue;
+        lower_hull_t lower_left_residue, lower_right_residue;
+        upper_hull_t upper_left_residue, upper_right_residue;
         LineSegment<Field> lower_bridge, upper_bridge;
+        bool merged = false;
         public:
         TreapNode<TotalOrder> *left = nullptr, *right = nullptr;
-        bool is_leaf() const { return false; }
-        inline DynamicHull::priority_t priority() const { return _priority; }
-        inline TotalOrder lo() const { return _lo; }
-        inline TotalOrder hi() const { return _hi; }
-        inline lower_hull_t& lower_hull() { return _lower_hull; }
-        inline upper_hull_t& upper_hull() { return _upper_hull; }
-        inline void pull() {
-          _lo = left->lo(), _hi = right->hi();
-
-          lower_bridge = merge_lower_hulls(lower_hull(),
+        TreapBranch(DynamicHull::priority_t priority) : TreapNode<TotalOrder>(priority) { }
+        TreapBranch(TreapBranch const& branch) : TreapNode<TotalOrder>(branch),
+          lower_left_residue(branch.lower_left_residue), lower_right_residue(branch.lower_right_residue),
+          upper_left_residue(branch.upper_left_residue), upper_right_residue(branch.upper_right_residue),
+          lower_bridge(branch.lower_bridge), upper_bridge(branch.upper_bridge), merged(branch.merged),
+          left(branch.left), right(branch.right) {
+          lower_left_residue.acquire(), lower_right_residue.acquire();
+          upper_left_residue.acquire(), upper_right_residue.acquire();
+        }
+        ~TreapBranch() {
+          this->_lower_hull.destroy(), lower_left_residue.destroy(), lower_right_residue.destroy();
+          this->_upper_hull.destroy(), upper_left_residue.destroy(), upper_right_residue.destroy();
+        }
+        inline bool is_merged() const { return merged; }
+        /* A deferred pull only refreshes the bounds and leaves the children's hulls
+         * in place until a later pull merges them. */
+        inline void pull(bool defer = false) {
+          this->_lo = left->lo(), this->_hi = right->hi();
+          if( defer ) return;
+          DPCH_COUNT(pulls);
+          merged = true;
+          own(left), own(right); // their hulls are handed over to this branch
+
+          lower_bridge = merge_lower_hulls(this->lower_hull(),
               left->lower_hull(), right->lower_hull(),
               lower_left_residue, lower_right_residue);
 
-          upper_bridge = merge_upper_hulls(upper_hull(),
+          upper_bridge = merge_upper_hulls(this->upper_hull(),
               left->upper_hull(), right->upper_hull(),
               upper_left_residue, upper_right_residue);
         }
         void push() {
-          split_lower_hulls(lower_bridge, lower_hull(),
+          if( not merged ) return;
+          DPCH_COUNT(pushes);
+          merged = false;
+          own(left), own(right);
+          split_lower_hulls(lower_bridge, this->lower_hull(),
               left->lower_hull(), right->lower_hull(),
               lower_left_residue, lower_right_residue);
 
-          split_upper_hulls(upper_bridge, upper_hull(),
+          split_upper_hulls(upper_bridge, this->upper_hull(),
               left->upper_hull(), right->upper_hull(),
               upper_left_residue, upper_right_residue);
         }
       };
 
+      /* Makes node writable by this version, copying it if it is shared. */
+      template< typename TotalOrder > static void own(TreapNode<TotalOrder>* &node) {
+        if( not node->is_shared() ) return;
+        node->release();
+        if( node->is_leaf() ) {
+          node = new TreapLeaf<TotalOrder>(*static_cast<TreapLeaf<TotalOrder>*>(node));
+        } else {
+          auto copy = new TreapBranch<TotalOrder>(*static_cast<TreapBranch<TotalOrder>*>(node));
+          copy->left->acquire(), copy->right->acquire();
+          node = copy;
+        }
+      }
+
+      /* Drops a reference to tree, freeing the nodes no other version refers to. */
+      template< typename TotalOrder > void erase(TreapNode<TotalOrder> *tree) {
+        if( tree == nullptr or not tree->release() ) return;
+        if( tree->is_leaf() ) return void(delete static_cast<TreapLeaf<TotalOrder>*>(tree));
+        auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
+        erase(_tree->left), erase(_tree->right);
+        delete _tree;
+      }
+
+      /* Nodes built for a bulk build per task. */
+      static constexpr size_t build_grain = 1 << 12;
+
+      /* Lays out a Cartesian tree over the gaps between consecutive sorted points,
+       * then merges hulls bottom up so that every branch is pulled exactly once. The
+       * nodes are built in parallel, with priorities drawn by index so that the shape
+       * does not depend on the threads, under a shared arena unless forks use it too. */
+      template< typename TotalOrder > TreapNode<TotalOrder>* build(
+          std::vector<TotalOrder> const& points, ForkJoin& pool) {
+        if( points.empty() ) return nullptr;
+        size_t n = points.size();
+        std::vector< TreapNode<TotalOrder>* > leaves(n);
+        std::vector< TreapBranch<TotalOrder>* > branches(n - 1); // branches[i] between leaves[i] and leaves[i+1]
+        auto blocks = [&](size_t count, auto const& task) {
+          parallel_for(pool, 0, (count + build_grain - 1) / build_grain, [&](size_t block) {
+              for(size_t i = block * build_grain; i < std::min(count, (block + 1) * build_grain); i++) task(i);
+              });
+        };
+        bool parallel = pool.threads() > 1 and arena.use_count() == 1;
+        arena->reserve(2 * n), arena->share(parallel);
+        blocks(n, [&](size_t i) {
+            leaves[i] = new TreapLeaf<TotalOrder>(points[i], *arena, i);
+            if( i + 1 < n ) branches[i] = new TreapBranch<TotalOrder>(priorities.peek(i));
+            });
+        arena->share(false), arena->skip_priorities(2 * n), priorities.skip(n - 1);
+        auto root = lay_out(branches, 0, n - 1, pool);
+        blocks(n - 1, [&](size_t i) {
+            if( branches[i]->left == nullptr ) branches[i]->left = leaves[i];
+            if( branches[i]->right == nullptr ) branches[i]->right = leaves[i + 1];
+            });
+        if( root == nullptr ) return leaves.front();
+        pull_dirty(root, pool);
+        return root;
+      }
+
+      /* The Cartesian tree of branches[first, last) by priority, earlier branches above
+       * on ties and null children where leaves go: a stack keeps its right spine as
+       * branches are added, and halves laid out in parallel are zipped together along
+       * the spines where they meet. */
+      template< typename TotalOrder > static TreapBranch<TotalOrder>* lay_out(
+          std::vector< TreapBranch<TotalOrder>* > const& branches, size_t first, size_t last, ForkJoin& pool) {
+        if( pool.threads() > 1 and last - first > build_grain ) {
+          size_t middle = first + (last - first) / 2;
+          TreapBranch<TotalOrder> *left, *right;
+          pool.fork([&] { left = lay_out(branches, first, middle, pool); },
+              [&] { right = lay_out(branches, middle, last, pool); });
+          return zip(left, right);
+        }
+        std::vector< TreapBranch<TotalOrder>* > spine;
+        for(size_t i = first; i < last; i++) {
+          auto branch = branches[i];
+          TreapBranch<TotalOrder> *below = nullptr;
+          while( not spine.empty() and spine.back()->priority() < branch->priority() )
+            below = spine.back(), spine.pop_back();
+          branch->left = below;
+          if( not spine.empty() ) spine.back()->right = branch;
+          spine.push_back(branch);
+        }
+        return spine.empty() ? nullptr : spine.front();
+      }
+
+      template< typename TotalOrder > static TreapBranch<TotalOrder>* zip(
+          TreapBranch<TotalOrder>* left, TreapBranch<TotalOrder>* right) {
+        if( left == nullptr or right == nullptr ) return left == nullptr ? right : left;
+        if( left->priority() >= right->priority() ) {
+          left->right = zip(static_cast<TreapBranch<TotalOrder>*>(left->right), right);
+          return left;
+        }
+        right->left = zip(left, static_cast<TreapBranch<TotalOrder>*>(right->left));
+        return right;
+      }
+
+      /* Merges every branch whose hulls are split, children first. Split branches
+       * always form a subtree hanging from the root, and siblings are merged in
+       * parallel down to a few times as many tasks as there are threads. A version
+       * with live forks merges sequentially, since copying a shared segment drops a
+       * reference that tasks on other subtrees may be counting as well. */
+      template< typename TotalOrder > void pull_dirty(TreapNode<TotalOrder> *tree, ForkJoin& pool) {
+        int depth = 3;
+        for(unsigned threads = pool.threads(); threads > 1; threads >>= 1) depth++;
+        bool parallel = pool.threads() > 1 and arena.use_count() == 1;
+        if( parallel ) arena->reserve(2 * count_dirty(tree)); // one bridge per hull
+        arena->share(parallel);
+        pull_dirty(tree, pool, parallel ? depth : 0);
+        arena->share(false);
+      }
+
+      template< typename TotalOrder > size_t count_dirty(TreapNode<TotalOrder> *tree) const {
+        if( tree == nullptr or tree->is_leaf() ) return 0;
+        auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
+        if( _tree->is_merged() ) return 0;
+        return 1 + count_dirty(_tree->left) + count_dirty(_tree->right);
+      }
+
+      template< typename TotalOrder > void pull_dirty(TreapNode<TotalOrder> *tree, ForkJoin& pool, int depth) {
+        if( tree == nullptr or tree->is_leaf() ) return;
+        auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
+        if( _tree->is_merged() ) return;
+        if( depth > 0 ) {
+          pool.fork([&] { pull_dirty(_tree->left, pool, depth - 1); },
+              [&] { pull_dirty(_tree->right, pool, depth - 1); });
+        } else {
+          pull_dirty(_tree->left, pool, 0), pull_dirty(_tree->right, pool, 0);
+        }
+        _tree->pull();
+      }
+
       template< typename TotalOrder > void join(TreapNode<TotalOrder>* & root,
           TreapNode<TotalOrder> *left, TreapNode<TotalOrder> *right) {
-
+        DPCH_LEVEL(height);
         if( left == nullptr or right == nullptr )
           return void(root = (left == nullptr ? right : left));
 
         if( left->is_leaf() and right->is_leaf() ) {
           auto* _root = static_cast<TreapBranch<TotalOrder>*>(root);
-          _root = new TreapBranch<TotalOrder>();
+          _root = new TreapBranch<TotalOrder>(priorities());
           _root->left = left, _root->right = right;
-          root = _root, _root->pull();
+          root = _root, _root->pull(deferred);
           return;
         }
 
         if( left->priority() < right->priority() ) {
+          own(right);
           auto _right = static_cast<TreapBranch<TotalOrder>*>(right);
           _right->push(); 
           join(_right->left, left, _right->left);
           root = _right;
           if( _right->left->priority() > _right->priority() ) { // fix priority
+            own(_right->left);
             auto _left = static_cast<TreapBranch<TotalOrder>*>(_right->left);
             _left->push();
             auto temp = _left->right;
             _left->right = _right, _right->left = temp, root = _left;
-            _right->pull(), _left->pull();
+            _right->pull(deferred), _left->pull(deferred);
           } else {
-            _right->pull();
+            _right->pull(deferred);
           }
         } else {
+          own(left);
           auto _left = static_cast<TreapBranch<TotalOrder>*>(left);
           _left->push(); 
           join(_left->right, _left->right, right);
           root = _left;
           if( _left->right->priority() > _left->priority() ) { // fix priority
+            own(_left->right);
             auto _right = static_cast<TreapBranch<TotalOrder>*>(_left->right);
             _right->push();
             auto temp = _right->left;
             _right->left = _left, _left->right = temp, root = _right;
-            _left->pull(), _right->pull();
+            _left->pull(deferred), _right->pull(deferred);
           } else {
-            _left->pull();
+            _left->pull(deferred);
           }
         }
       }
 
       template< typename TotalOrder > bool remove(
           TotalOrder const& point, TreapNode<TotalOrder> *&tree, TreapBranch<TotalOrder> *parent = nullptr) {
+        DPCH_LEVEL(height);
         if( tree == nullptr ) return false;
         if( tree->is_leaf() ) {
-          auto leaf = static_cast<TreapLeaf<TotalOrder>*>(tree);
-          if( (leaf->hi() < point) or (point < leaf->lo()) ) return false;
-          delete leaf, tree = nullptr;
+          if( (tree->hi() < point) or (point < tree->lo()) ) return false;
+          erase(tree), tree = nullptr;
           return true;
         }
-        auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
-        if( (point < _tree->lo()) or (_tree->hi() < point) ) {
+        if( (point < tree->lo()) or (tree->hi() < point) ) {
           return false;
         }
-        auto &left_child = _tree->left, &right_child = _tree->right;
-        if( (left_child->hi() < point) and (point < right_child->lo()) ) {
+        auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
+        if( (_tree->left->hi() < point) and (point < _tree->right->lo()) ) {
           return false;
         }
+        own(tree), _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
+        auto &left_child = _tree->left, &right_child = _tree->right;
         _tree->push();
         bool was_present;
         if( not (left_child->hi() < point) ) {
@@ -201,7 +448,7 @@ namespace dpch {
             else parent->right = child;
           }
         } else {
-          _tree->pull();
+          _tree->pull(deferred);
         }
         return was_present;
       }
@@ -210,12 +457,14 @@ namespace dpch {
       template< typename TotalOrder > void cut(
           TotalOrder const& point, TreapNode<TotalOrder> *tree,
           TreapNode<TotalOrder> *&left, TreapNode<TotalOrder> *&right) {
+        DPCH_LEVEL(height);
         if( tree == nullptr ) { left = right = nullptr; return; }
         if(tree->is_leaf()) {
           if( tree->lo() < point ) left = tree, right = nullptr;
           else left = nullptr, right = tree;
           return;
         }
+        own(tree);
         auto _tree = static_cast<TreapBranch<TotalOrder>*>(tree);
         _tree->push();
         auto &left_child = _tree->left, &right_child = _tree->right;
@@ -224,11 +473,11 @@ namespace dpch {
         if( not (left_child->hi() < point) ) {
           cut(point, left_child, left, left_child);
           right = _tree;
-          _tree->pull();
+          _tree->pull(deferred);
         } else if( right_child->lo() < point ) {
           cut(point, right_child, right_child, right);
           left = _tree;
-          _tree->pull();
+          _tree->pull(deferred);
         } else { // left_child->hi() < point <= right_child->lo()
           left = left_child, right = right_child;
           delete _tree; _tree = nullptr;
@@ -239,191 +488,165 @@ namespace dpch {
           TotalOrder const& point, TreapNode<TotalOrder> *&tree) {
         TreapNode<TotalOrder> *left, *right;
         cut(point, tree, left, right);
-        TreapLeaf<TotalOrder> *leaf = new TreapLeaf<TotalOrder>(point);
+        TreapLeaf<TotalOrder> *leaf = new TreapLeaf<TotalOrder>(point, *arena);
         join(right, leaf, right);
         join(tree, left, right);
       }
 
   };
 
-  template<typename Field> std::default_random_engine DynamicHull<Field>::engine;
-  template<typename Field> std::uniform_int_distribution< int32_t > DynamicHull<Field>::rng;
+  template<typename Field, typename Summary> template<typename Iterator>
+    DynamicHull<Field, Summary>::DynamicHull(Iterator first, Iterator last, bool sorted, unsigned threads)
+    { assign(first, last, sorted, threads); }
+
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::DynamicHull(DynamicHull&& other) { *this = std::move(other); }
+
+  /* The hull moved from is left with the points of this one, until it is destroyed. */
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>& DynamicHull<Field, Summary>::operator=(DynamicHull&& other) {
+    std::swap(arena, other.arena);
+    std::swap(_leaves, other._leaves), std::swap(master_root, other.master_root);
+    std::swap(priorities, other.priorities);
+    std::swap(stats, other.stats), std::swap(trace, other.trace);
+    return *this;
+  }
+
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::~DynamicHull() { erase(master_root); }
+
+  template<typename Field, typename Summary> DynamicHull<Field, Summary> DynamicHull<Field, Summary>::fork() {
+    DynamicHull copy;
+    copy.arena = arena, copy._leaves = _leaves, copy.master_root = master_root;
+    copy.priorities = priorities;
+    if( master_root != nullptr ) master_root->acquire();
+    return copy;
+  }
+
+  template<typename Field, typename Summary> void DynamicHull<Field, Summary>::seed(uint64_t _seed) {
+    priorities.seed(_seed), arena->seed(~_seed);
+  }
+
+  template<typename Field, typename Summary> template<typename Iterator>
+    void DynamicHull<Field, Summary>::assign(Iterator first, Iterator last, bool sorted, unsigned threads) {
+      DPCH_OPERATION(stats, trace, "assign");
+      erase(master_root), master_root = nullptr;
+      ForkJoin pool(threads);
+      std::vector< Point<Field> > points(first, last);
+      if( not sorted ) parallel_sort(pool, points.begin(), points.end());
+      arena->reserve(4 * points.size());
+      master_root = build(points, pool);
+      _leaves = points.size();
+    }
 
-  template<typename Field> void DynamicHull<Field>::add_point(Point<Field> const& point) {
+  template<typename Field, typename Summary> void DynamicHull<Field, Summary>::add_point(Point<Field> const& point) {
+    DPCH_OPERATION(stats, trace, "add_point");
     insert(point, master_root);
     _leaves++;
   }
 
-  template<typename Field> bool DynamicHull<Field>::remove_point(Point<Field> const& point) {
+  /* Deletions are applied before insertions; returns how many deleted points were present. */
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::size_t DynamicHull<Field, Summary>::apply_batch(
+      std::span< Point<Field> const > inserts, std::span< Point<Field> const > deletes, unsigned threads) {
+    DPCH_OPERATION(stats, trace, "apply_batch");
+    std::vector< Point<Field> > sorted_inserts(inserts.begin(), inserts.end());
+    std::vector< Point<Field> > sorted_deletes(deletes.begin(), deletes.end());
+    std::sort(sorted_inserts.begin(), sorted_inserts.end());
+    std::sort(sorted_deletes.begin(), sorted_deletes.end());
+
+    size_t removed = 0;
+    deferred = true;
+    for(auto const& point: sorted_deletes) removed += remove(point, master_root);
+    for(auto const& point: sorted_inserts) insert(point, master_root);
+    deferred = false;
+    _leaves += size_t(sorted_inserts.size()) - removed;
+
+    ForkJoin pool(threads);
+    pull_dirty(master_root, pool);
+    return removed;
+  }
+
+  template<typename Field, typename Summary> bool DynamicHull<Field, Summary>::remove_point(Point<Field> const& point) {
+    DPCH_OPERATION(stats, trace, "remove_point");
     bool was_present = remove(point, master_root);
     if( was_present ) _leaves--;
     return was_present;
   }
 
-  template<typename Field> DynamicHull<Field>::size_t DynamicHull<Field>::get_lower_hull_size() const {
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::size_t DynamicHull<Field, Summary>::get_lower_hull_size() const {
     return master_root == nullptr ? 0 : master_root->lower_hull().get_size();
   }
 
-  template<typename Field> DynamicHull<Field>::size_t DynamicHull<Field>::get_upper_hull_size() const {
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::size_t DynamicHull<Field, Summary>::get_upper_hull_size() const {
     return master_root == nullptr ? 0 : master_root->upper_hull().get_size();
   }
 
-  template<typename Field> DynamicHull<Field>::size_t DynamicHull<Field>::get_hull_size() const {
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::lower_hull_t const& DynamicHull<Field, Summary>::get_lower_hull() const {
+    static lower_hull_t const empty;
+    return master_root == nullptr ? empty : master_root->lower_hull();
+  }
+
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::upper_hull_t const& DynamicHull<Field, Summary>::get_upper_hull() const {
+    static upper_hull_t const empty;
+    return master_root == nullptr ? empty : master_root->upper_hull();
+  }
+
+  template<typename Field, typename Summary> DynamicHull<Field, Summary>::size_t DynamicHull<Field, Summary>::get_hull_size() const {
     return get_lower_hull_size() + get_upper_hull_size();
   }
 
-  template<typename Field> template<typename Callback>
-    void DynamicHull<Field>::traverse_lower_hull(Callback const& callback) const {
-      if( master_root == nullptr ) return;
-      for(auto const segment: master_root->lower_hull())
-        callback(segment);
+  template<typename Field, typename Summary> template<typename Callback>
+    void DynamicHull<Field, Summary>::traverse_lower_hull(Callback const& callback) const {
+      if( master_root != nullptr ) master_root->lower_hull().traverse(callback);
     }
 
-  template<typename Field> template<typename Callback> 
-    void DynamicHull<Field>::traverse_upper_hull(Callback const& callback) const {
-      if( master_root == nullptr ) return;
-      for(auto segment: master_root->upper_hull())
-        callback(segment);
+  template<typename Field, typename Summary> template<typename Callback> 
+    void DynamicHull<Field, Summary>::traverse_upper_hull(Callback const& callback) const {
+      if( master_root != nullptr ) master_root->upper_hull().traverse(callback);
     }
 
-  template<typename Field>
-    DynamicHull<Field>::size_t DynamicHull<Field>::get_num_points() const {
+  template<typename Field, typename Summary>
+    DynamicHull<Field, Summary>::size_t DynamicHull<Field, Summary>::get_num_points() const {
       return _leaves;
     }
 
-  template<typename Field> template<typename Callback>
-    void DynamicHull<Field>::__traverse_set(Callback const& callback, TreapNode<Point<Field>> *ptr) const {
-      if( ptr->is_leaf() ) { callback(ptr->point); return; }
+  template<typename Field, typename Summary> HullMeasures<Field> DynamicHull<Field, Summary>::measures() const {
+    static_assert( std::is_same_v< Summary, ChainSummary<Field> >, "measures need DynamicHull<Field, ChainSummary<Field>>" );
+    if( master_root == nullptr ) return {};
+    auto const& lower = master_root->lower_hull();
+    return { lower.get_summary(), master_root->upper_hull().get_summary(), lower.begin()->u, lower.rbegin()->v };
+  }
+
+  template<typename Field, typename Summary> template<typename Callback>
+    void DynamicHull<Field, Summary>::__traverse_set(Callback const& callback, TreapNode<Point<Field>> *ptr) const {
+      if( ptr->is_leaf() ) { callback(ptr->lo()); return; }
       auto _ptr = static_cast< TreapBranch<Point<Field>>* >(ptr);
       __traverse_set(callback, _ptr->left), __traverse_set(callback, _ptr->right);
     }
 
-  template<typename Field> template<typename Callback>
-    void DynamicHull<Field>::traverse_set(Callback const& callback) const { __traverse_set(callback, master_root); }
+  template<typename Field, typename Summary> template<typename Callback>
+    void DynamicHull<Field, Summary>::traverse_set(Callback const& callback) const {
+      if( master_root != nullptr ) __traverse_set(callback, master_root);
+    }
 
   /* Point in polygon, tangent and farthest point queries. */
 
-  template<typename Field> bool DynamicHull<Field>::point_in_polygon(Point<Field> const& point) {
-    auto const& lower_hull = master_root->lower_hull();
-    auto const& upper_hull = master_root->upper_hull();
-
-    auto const lower_segment = lower_hull.binary_search(
-        [&](lower_hull_t::iterator const& seg) { return point < seg->v; });
-    auto const upper_segment = upper_hull.binary_search(
-        [&](upper_hull_t::iterator const& seg) { return point < seg->v; });
-
-    bool lower_enclosed = lower_segment != lower_hull.end() and
-      (lower_segment->v - lower_segment->u) * (point - lower_segment->u) > 0;
-    bool upper_enclosed = upper_segment != upper_hull.end() and
-      (upper_segment->v - upper_segment->u) * (point - upper_segment->u) < 0;
-
-    return lower_enclosed and upper_enclosed;
+  template<typename Field, typename Summary> bool DynamicHull<Field, Summary>::point_in_polygon(Point<Field> const& point) const {
+    return __point_in_polygon(get_lower_hull(), get_upper_hull(), point);
   }
 
-  template<typename Field> std::optional< std::pair< Point<Field>, Point<Field> > >
-    DynamicHull<Field>::get_tangents (Point<Field> const& point) const {
-      if( get_hull_size() <= 2 ) {
-        auto ret = *(master_root->lower_hull().begin());
-        return {{ret.u, ret.v}};
-      }
-      auto const& lower_hull = master_root->lower_hull();
-      auto const& upper_hull = master_root->upper_hull();
-
-      auto first = lower_hull.begin()->u, last = upper_hull.rbegin()->v;
-
-      if( point < first ) {
-        auto lower_segment = lower_hull.binary_search([&](lower_hull_t::iterator const& seg)
-            { return (seg->v-seg->u)*(point-seg->u) > 0;});
-        auto lower_tangent = lower_segment == lower_hull.end() ? last : lower_segment->u;
-
-        auto upper_segment = upper_hull.binary_search([&](upper_hull_t::iterator const& seg)
-            { return (seg->v-seg->u)*(point-seg->u) < 0;});
-        auto upper_tangent = upper_segment == upper_hull.end() ? last : upper_segment->u;
-
-        if( upper_tangent < lower_tangent ) std::swap(upper_tangent, lower_tangent);
-        return {{lower_tangent, upper_tangent}};
-      } else if( last < point ) {
-        auto lower_segment = lower_hull.binary_search([&](lower_hull_t::iterator const& seg)
-            { return (seg->v-seg->u)*(point-seg->u) <= 0;});
-        auto lower_tangent = lower_segment == lower_hull.end() ? last : lower_segment->u;
-
-        auto upper_segment = upper_hull.binary_search([&](upper_hull_t::iterator const& seg)
-            { return (seg->v-seg->u)*(point-seg->u) >= 0;});
-        auto upper_tangent = upper_segment == upper_hull.end() ? last : upper_segment->u;
-
-        if( upper_tangent < lower_tangent ) std::swap(upper_tangent, lower_tangent);
-        return {{lower_tangent, upper_tangent}};
-      } else {
-        auto const lower_segment = lower_hull.binary_search(
-            [&](lower_hull_t::iterator const& seg) { return point < seg->v; });
-        auto const upper_segment = upper_hull.binary_search(
-            [&](upper_hull_t::iterator const& seg) { return point < seg->v; });
-
-        bool lower_enclosed = lower_segment != lower_hull.end() and
-          (lower_segment->v - lower_segment->u) * (point - lower_segment->u) > 0;
-        bool upper_enclosed = upper_segment != upper_hull.end() and
-          (upper_segment->v - upper_segment->u) * (point - upper_segment->u) < 0;
-
-        if( lower_enclosed and upper_enclosed ) return {};
-
-        if( lower_enclosed ) { // => not upper_enclosed
-          auto left_segment = upper_hull.binary_search(
-              [&](upper_hull_t::iterator const& seg)
-              { return point < seg->v or (seg->v-seg->u)*(point-seg->u) >= 0; });
-          auto left_tangent = left_segment == upper_hull.end() ? first : left_segment->u;
-
-          auto right_segment = upper_hull.binary_search(
-              [&](upper_hull_t::iterator const& seg)
-              { return point < seg->u and (seg->v-seg->u)*(point-seg->u) < 0; });
-          auto right_tangent =
-            right_segment == upper_hull.end() ? last : right_segment->u;
-
-          if( right_tangent < left_tangent ) std::swap(left_tangent, right_tangent);
-          return {{left_tangent, right_tangent}};
-        } else { 
-          auto left_segment = lower_hull.binary_search(
-              [&](lower_hull_t::iterator const& seg)
-              { return point < seg->v or (seg->v-seg->u)*(point-seg->u) <= 0; });
-          auto left_tangent = left_segment == lower_hull.end() ? first : left_segment->u;
-
-          auto right_segment = lower_hull.binary_search(
-              [&](lower_hull_t::iterator const& seg)
-              { return point < seg->u and (seg->v-seg->u)*(point-seg->u) > 0; });
-          auto right_tangent =
-            right_segment == lower_hull.end() ? last : right_segment->u;
-
-          if( right_tangent < left_tangent ) std::swap(left_tangent, right_tangent);
-          return {{left_tangent, right_tangent}};
-        }
-      }
-
-      return {}; // never occurs
-    };
-
-  template<typename Field> std::pair< Point<Field>, Point<Field> >
-    DynamicHull<Field>::get_extremal_points (Point<Field> const& direction) const {
-      auto const& lower_hull = master_root->lower_hull();
-      auto const& upper_hull = master_root->upper_hull();
-
-      auto first = lower_hull.begin()->u, last = upper_hull.rbegin()->v;
-
-      LineSegment<Field> segment{first, last};
-      if( direction.y > 0 or (direction.y == 0 and direction.x < 0) ) {
-        auto udip = [&direction](upper_hull_t::iterator const& seg)
-        { return ((seg->v - seg->u) ^ direction) <= 0; };
-        auto seg = upper_hull.binary_search(udip);
-        if( seg != upper_hull.end() ) segment = *seg;
-      } else {
-        auto ldip = [&direction](lower_hull_t::iterator const& seg)
-        { return ((seg->v - seg->u) ^ direction) <= 0; };
-        auto seg = lower_hull.binary_search(ldip);
-        if( seg != lower_hull.end() ) segment = *seg;
-      }
+  template<typename Field, typename Summary> std::optional< std::pair< Point<Field>, Point<Field> > >
+    DynamicHull<Field, Summary>::get_tangents (Point<Field> const& point) const {
+      return __get_tangents(get_lower_hull(), get_upper_hull(), point, get_hull_size());
+    }
 
-      if( (segment.v ^ direction) < (segment.u ^ direction) ) segment.v = segment.u;
-      if( (segment.u ^ direction) < (segment.v ^ direction) ) segment.u = segment.v;
+  template<typename Field, typename Summary> std::pair< Point<Field>, Point<Field> >
+    DynamicHull<Field, Summary>::get_extremal_points (Point<Field> const& direction) const {
+      return __get_extremal_points(get_lower_hull(), get_upper_hull(), direction);
+    }
 
-      return {segment.u, segment.v};
-    };
+  template<typename Field, typename Summary> std::vector< std::pair< Point<Field>, Point<Field> > >
+    DynamicHull<Field, Summary>::get_extremal_points_batch (std::span< Point<Field> const > directions) const {
+      std::vector< std::pair< Point<Field>, Point<Field> > > extremes(directions.size());
+      __get_extremal_points_batch< Field >(get_lower_hull(), get_upper_hull(), directions, std::span(extremes));
+      return extremes;
+    }
 
 }; // end namespace dpch
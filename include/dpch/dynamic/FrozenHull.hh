@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <span>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/util/ForkJoin.hh>
+#include <dpch/dynamic/HullQueries.hh>
+
+namespace dpch {
+
+  /* Immutable copy of the chains of a hull, answering the same queries as
+   * DynamicHull from flat arrays so that any number of threads can share it. */
+  template<typename Field> class FrozenHull {
+    public:
+
+      using size_t = int32_t;
+
+      class Chain {
+        public:
+          using iterator = typename std::vector< LineSegment<Field> >::const_iterator;
+
+          iterator begin() const { return segments.begin(); }
+          iterator end() const { return segments.end(); }
+          auto rbegin() const { return segments.rbegin(); }
+
+          template<typename Predicate> iterator binary_search(Predicate const&) const;
+          template<typename Predicate, typename Callback> void batch_search(std::size_t, Predicate const&, Callback const&) const;
+
+          size_t get_size() const { return size_t(segments.size()); }
+
+        private:
+          friend class FrozenHull;
+          std::vector< LineSegment<Field> > segments;
+          std::size_t first_vertex = 0; // of the chain in xs and ys
+
+          template<typename Predicate, typename Callback> void __batch_search(Predicate const&, Callback const&,
+              iterator, iterator, std::size_t, std::size_t) const;
+      };
+
+      FrozenHull() = default;
+      template<typename Hull> explicit FrozenHull(Hull const&);
+
+      bool point_in_polygon(Point<Field> const&) const;
+
+      std::optional< std::pair< Point<Field>, Point<Field> > >
+        get_tangents (Point<Field> const&) const;
+
+      /* The hull must not be empty. */
+      std::pair< Point<Field>, Point<Field> >
+        get_extremal_points(Point<Field> const&) const;
+
+      /* get_extremal_points for every direction; enough of them are sorted by angle and
+       * searched for together, see __get_extremal_points_batch. */
+      std::vector< std::pair< Point<Field>, Point<Field> > >
+        get_extremal_points_batch(std::span< Point<Field> const >) const;
+
+      /* point_in_polygon and get_tangents for every point, a few lanes of points at a time
+       * stepping through the chains together; threads split large batches. */
+      std::vector< uint8_t > point_in_polygon_batch(std::span< Point<Field> const >, unsigned threads = 1) const;
+      std::vector< std::optional< std::pair< Point<Field>, Point<Field> > > >
+        get_tangents_batch(std::span< Point<Field> const >, unsigned threads = 1) const;
+
+      template<typename Callback> void traverse_lower_hull(Callback const&) const;
+      template<typename Callback> void traverse_upper_hull(Callback const&) const;
+
+      size_t get_lower_hull_size() const { return lower_hull.get_size(); }
+      size_t get_upper_hull_size() const { return upper_hull.get_size(); }
+      size_t get_hull_size() const { return get_lower_hull_size() + get_upper_hull_size(); }
+
+    private:
+      Chain lower_hull, upper_hull;
+      std::vector< Field > xs, ys; // vertices of the lower chain, then of the upper chain
+
+      static constexpr std::size_t lanes = 8, grain = 1 << 14;
+      /* Below this many vertices a scalar search is short enough to beat the lanes. */
+      static constexpr int32_t search_lanes_from = 256;
+
+      /* Binary searches of many points over the chains at once, see __search_lanes. */
+      template<std::size_t Lanes> struct Searches {
+        Point<Field> points[Lanes];
+        uint32_t first[Lanes], size[Lanes], found[Lanes];
+        uint8_t positive[Lanes], negative[Lanes], zero[Lanes], before_u[Lanes], before_v[Lanes];
+      };
+
+      template<typename Task> static void __for_blocks(std::size_t, unsigned, Task const&);
+      template<std::size_t Lanes> void __locate(Chain const&, Point<Field> const*, uint32_t*) const;
+      template<std::size_t Lanes> void __search_lanes(Searches<Lanes>&) const;
+      bool __enclosed(Point<Field> const&, uint32_t, uint32_t) const;
+      void __point_in_polygon_lanes(Point<Field> const*, std::size_t, uint8_t*) const;
+      void __get_tangents_lanes(Point<Field> const*, std::size_t,
+          std::optional< std::pair< Point<Field>, Point<Field> > >*) const;
+  };
+
+  /* Copies the chains of anything with traverse_{lower,upper}_hull over segments. */
+  template<typename Field> template<typename Hull> FrozenHull<Field>::FrozenHull(Hull const& hull) {
+    lower_hull.segments.reserve(hull.get_lower_hull_size());
+    upper_hull.segments.reserve(hull.get_upper_hull_size());
+    hull.traverse_lower_hull([this](LineSegment<Field> const& segment) { lower_hull.segments.push_back(segment); });
+    hull.traverse_upper_hull([this](LineSegment<Field> const& segment) { upper_hull.segments.push_back(segment); });
+    for(auto chain: { &lower_hull, &upper_hull }) {
+      chain->first_vertex = xs.size();
+      if( chain->segments.empty() ) continue;
+      xs.push_back(chain->segments.front().u.x), ys.push_back(chain->segments.front().u.y);
+      for(auto const& segment: chain->segments) xs.push_back(segment.v.x), ys.push_back(segment.v.y);
+    }
+  }
+
+  template<typename Field> template<typename Predicate> typename FrozenHull<Field>::Chain::iterator
+    FrozenHull<Field>::Chain::binary_search(Predicate const& predicate) const {
+      auto first = segments.begin(), last = segments.end();
+      while( first != last ) {
+        auto middle = first + (last - first) / 2;
+        if( predicate(middle) ) last = middle;
+        else first = middle + 1;
+      }
+      return first;
+    }
+
+  /* The batch_search of DynamicArray over the implicit tree of binary_search. */
+  template<typename Field> template<typename Predicate, typename Callback>
+    void FrozenHull<Field>::Chain::batch_search(std::size_t n, Predicate const& predicate, Callback const& callback) const {
+      __batch_search(predicate, callback, segments.begin(), segments.end(), 0, n);
+    }
+
+  template<typename Field> template<typename Predicate, typename Callback>
+    void FrozenHull<Field>::Chain::__batch_search(Predicate const& predicate, Callback const& callback,
+        iterator first, iterator last, std::size_t first_query, std::size_t last_query) const {
+      if( first_query == last_query ) return;
+      if( first == last ) {
+        for(auto query = first_query; query < last_query; query++) callback(query, first);
+        return;
+      }
+      auto middle = first + (last - first) / 2;
+      auto lo = first_query, hi = last_query;
+      while( lo < hi ) {
+        auto query = lo + (hi - lo) / 2;
+        if( predicate(middle, query) ) lo = query + 1;
+        else hi = query;
+      }
+      __batch_search(predicate, callback, first, middle, first_query, lo);
+      __batch_search(predicate, callback, middle + 1, last, lo, last_query);
+    }
+
+  /* For Lanes points at once, the index of the first segment of chain ending after each
+   * point, or the number of segments: the search of __point_in_polygon. Every lane takes
+   * the same number of steps over the ends, each a conditional add, so that the lanes
+   * advance in lockstep without branches and their loads overlap. */
+  template<typename Field> template<std::size_t Lanes>
+    void FrozenHull<Field>::__locate(Chain const& chain, Point<Field> const* points, uint32_t* found) const {
+      uint32_t at[Lanes] = {}; // not found itself, which the compiler cannot tell from xs and ys
+      uint32_t n = chain.segments.size();
+      if( n > 0 ) {
+        Field const *ends_x = xs.data() + chain.first_vertex + 1, *ends_y = ys.data() + chain.first_vertex + 1;
+        auto at_or_before = [&](uint32_t i, Point<Field> const& point)
+        { return uint32_t(ends_x[i] < point.x) | (uint32_t(ends_x[i] == point.x) & uint32_t(ends_y[i] <= point.y)); };
+        for(; n > 1; ) {
+          uint32_t half = n / 2;
+          for(uint32_t lane = 0; lane < Lanes; lane++) at[lane] += half * at_or_before(at[lane] + half, points[lane]);
+          n -= half;
+        }
+        for(uint32_t lane = 0; lane < Lanes; lane++) at[lane] += at_or_before(at[lane], points[lane]);
+      }
+      std::copy(at, at + Lanes, found);
+    }
+
+  /* For every lane, the first of the size segments whose vertices start at first in xs
+   * and ys that passes the test of the lane, or size if none does: the binary searches
+   * of __get_tangents. A segment passes when the turn from its ends to the point has a
+   * sign the lane accepts, and when before_u is set the point precedes its first end; or
+   * when before_v is set and the point precedes its second end. The lanes step together
+   * as in __locate, searching past their own chains as if every segment there passed.
+   * A step takes the turns of all lanes before testing any; for doubles these are the
+   * filtered turns, and only the lanes the filter cannot settle take the exact ones. */
+  template<typename Field> template<std::size_t Lanes>
+    void FrozenHull<Field>::__search_lanes(Searches<Lanes>& search) const {
+      // doubles keep the filtered turns, NaN where unsettled; other fields their signs
+      using turn_t = std::conditional_t< std::is_same_v< Field, double >, double, int8_t >;
+      turn_t turns[Lanes];
+      uint32_t at[Lanes];
+      uint8_t passes[Lanes];
+      auto step = [&] {
+        for(uint32_t lane = 0; lane < Lanes; lane++) {
+          uint32_t i = search.first[lane] + std::min(at[lane], search.size[lane] - 1);
+          Point<Field> u(xs[i], ys[i]), v(xs[i+1], ys[i+1]);
+          if constexpr ( std::is_same_v< Field, double > ) turns[lane] = __filtered_orientation(u, v, search.points[lane]);
+          else {
+            auto turn = orientation(u, v, search.points[lane]);
+            turns[lane] = int8_t((turn > 0) - (turn < 0));
+          }
+        }
+        if constexpr ( std::is_same_v< Field, double > )
+          for(uint32_t lane = 0; lane < Lanes; lane++) {
+            if( not std::isnan(turns[lane]) ) [[likely]] continue;
+            uint32_t i = search.first[lane] + std::min(at[lane], search.size[lane] - 1);
+            turns[lane] = __exact_orientation(Point<Field>(xs[i], ys[i]), Point<Field>(xs[i+1], ys[i+1]), search.points[lane]);
+          }
+        for(uint32_t lane = 0; lane < Lanes; lane++) {
+          uint32_t i = search.first[lane] + std::min(at[lane], search.size[lane] - 1);
+          auto const& point = search.points[lane];
+          uint8_t before_u = (point.x < xs[i]) | ((point.x == xs[i]) & (point.y < ys[i]));
+          uint8_t before_v = (point.x < xs[i+1]) | ((point.x == xs[i+1]) & (point.y < ys[i+1]));
+          uint8_t turn = ((turns[lane] > 0) & search.positive[lane]) | ((turns[lane] < 0) & search.negative[lane]) |
+            ((turns[lane] == 0) & search.zero[lane]);
+          passes[lane] = (at[lane] >= search.size[lane]) | (turn & (before_u | (1 - search.before_u[lane]))) |
+            (before_v & search.before_v[lane]);
+        }
+      };
+      uint32_t n = *std::max_element(search.size, search.size + Lanes);
+      std::fill(search.found, search.found + Lanes, 0);
+      for(; n > 1; ) {
+        uint32_t half = n / 2;
+        for(uint32_t lane = 0; lane < Lanes; lane++) at[lane] = search.found[lane] + half;
+        step();
+        for(uint32_t lane = 0; lane < Lanes; lane++) search.found[lane] += half * (1 - passes[lane]);
+        n -= half;
+      }
+      std::copy(search.found, search.found + Lanes, at);
+      step();
+      for(uint32_t lane = 0; lane < Lanes; lane++) search.found[lane] += 1 - passes[lane];
+    }
+
+  /* Runs task(first, last) over blocks of up to grain indices, on up to threads threads. */
+  template<typename Field> template<typename Task>
+    void FrozenHull<Field>::__for_blocks(std::size_t n, unsigned threads, Task const& task) {
+      ForkJoin pool(threads);
+      parallel_for(pool, 0, (n + grain - 1) / grain,
+          [&](std::size_t block) { task(block * grain, std::min(n, (block + 1) * grain)); });
+    }
+
+  /* Whether point is enclosed, given the segments __locate found for it. */
+  template<typename Field> bool FrozenHull<Field>::__enclosed(Point<Field> const& point,
+      uint32_t lower, uint32_t upper) const {
+    if( lower >= lower_hull.segments.size() or upper >= upper_hull.segments.size() ) return false;
+    auto const& lower_segment = lower_hull.segments[lower];
+    auto const& upper_segment = upper_hull.segments[upper];
+    return orientation(lower_segment.u, lower_segment.v, point) > 0 and
+      orientation(upper_segment.u, upper_segment.v, point) < 0;
+  }
+
+  /* __point_in_polygon for n points, lanes at a time; the tail is padded with copies of
+   * the last point. */
+  template<typename Field> void FrozenHull<Field>::__point_in_polygon_lanes(
+      Point<Field> const* points, std::size_t n, uint8_t* inside) const {
+    Point<Field> block[lanes];
+    uint32_t lower[lanes], upper[lanes];
+    for(std::size_t first = 0; first < n; first += lanes) {
+      std::size_t count = std::min(lanes, n - first);
+      std::copy(points + first, points + first + count, block);
+      std::fill(block + count, block + lanes, block[count - 1]);
+      __locate< lanes >(lower_hull, block, lower);
+      __locate< lanes >(upper_hull, block, upper);
+      for(std::size_t lane = 0; lane < count; lane++) inside[first + lane] = __enclosed(block[lane], lower[lane], upper[lane]);
+    }
+  }
+
+  /* __get_tangents for n points on a hull of more than two points. A point the hull
+   * does not enclose has its tangents at the first ends of the segments two binary
+   * searches find, or at an end of the hull if they find none; where the point lies,
+   * left or right of the hull or above or below it, picks their chains and tests.
+   * Points are located lanes at a time, and those left outside queued until lanes of
+   * them fill both searches of every lane, run together in __search_lanes. */
+  template<typename Field> void FrozenHull<Field>::__get_tangents_lanes(Point<Field> const* points, std::size_t n,
+      std::optional< std::pair< Point<Field>, Point<Field> > >* tangents) const {
+    Point<Field> block[lanes];
+    uint32_t lower[lanes], upper[lanes];
+    std::size_t queued[lanes], n_queued = 0; // of points outside, with the lower segment they located
+    uint32_t queued_lower[lanes];
+    Searches< 2 * lanes > search;
+    auto const first = lower_hull.segments.front().u, last = upper_hull.segments.back().v;
+    auto test = [&](std::size_t lane, Point<Field> const& point, Chain const& chain, uint8_t positive,
+        uint8_t negative, uint8_t zero, uint8_t before_u, uint8_t before_v) {
+      search.points[lane] = point;
+      search.first[lane] = chain.first_vertex, search.size[lane] = chain.segments.size();
+      search.positive[lane] = positive, search.negative[lane] = negative, search.zero[lane] = zero;
+      search.before_u[lane] = before_u, search.before_v[lane] = before_v;
+    };
+    auto end = [&](std::size_t lane, Point<Field> const& otherwise) {
+      if( search.found[lane] == search.size[lane] ) return otherwise;
+      std::size_t i = search.first[lane] + search.found[lane];
+      return Point<Field>(xs[i], ys[i]);
+    };
+    auto flush = [&] {
+      for(std::size_t lane = 0; lane < lanes; lane++) {
+        std::size_t q = std::min(lane, n_queued - 1);
+        auto const& point = points[queued[q]];
+        if( point < first ) test(lane, point, lower_hull, 1, 0, 0, 0, 0), test(lanes + lane, point, upper_hull, 0, 1, 0, 0, 0);
+        else if( last < point ) test(lane, point, lower_hull, 0, 1, 1, 0, 0), test(lanes + lane, point, upper_hull, 1, 0, 1, 0, 0);
+        else if( queued_lower[q] < lower_hull.segments.size() and
+            orientation(lower_hull.segments[queued_lower[q]].u, lower_hull.segments[queued_lower[q]].v, point) > 0 )
+          test(lane, point, upper_hull, 1, 0, 1, 0, 1), test(lanes + lane, point, upper_hull, 0, 1, 0, 1, 0);
+        else test(lane, point, lower_hull, 0, 1, 1, 0, 1), test(lanes + lane, point, lower_hull, 1, 0, 0, 1, 0);
+      }
+      __search_lanes< 2 * lanes >(search);
+      for(std::size_t lane = 0; lane < n_queued; lane++) {
+        auto const& point = points[queued[lane]];
+        bool between = not (point < first or last < point);
+        auto left = end(lane, between ? first : last), right = end(lanes + lane, last);
+        if( right < left ) std::swap(left, right);
+        tangents[queued[lane]] = {{left, right}};
+      }
+      n_queued = 0;
+    };
+    for(std::size_t start = 0; start < n; start += lanes) {
+      std::size_t count = std::min(lanes, n - start);
+      std::copy(points + start, points + start + count, block);
+      std::fill(block + count, block + lanes, block[count - 1]);
+      __locate< lanes >(lower_hull, block, lower);
+      __locate< lanes >(upper_hull, block, upper);
+      for(std::size_t lane = 0; lane < count; lane++) {
+        auto const& point = block[lane];
+        if( not (point < first or last < point) and __enclosed(point, lower[lane], upper[lane]) ) continue;
+        queued_lower[n_queued] = lower[lane], queued[n_queued++] = start + lane;
+        if( n_queued == lanes ) flush();
+      }
+    }
+    if( n_queued > 0 ) flush();
+  }
+
+  template<typename Field> std::vector< uint8_t >
+    FrozenHull<Field>::point_in_polygon_batch(std::span< Point<Field> const > points, unsigned threads) const {
+      std::vector< uint8_t > inside(points.size());
+      __for_blocks(points.size(), threads, [&](std::size_t first, std::size_t last)
+          { __point_in_polygon_lanes(points.data() + first, last - first, inside.data() + first); });
+      return inside;
+    }
+
+  /* Smaller hulls locate points in lanes and search for the tangents of those outside
+   * with get_tangents, one point at a time. */
+  template<typename Field> std::vector< std::optional< std::pair< Point<Field>, Point<Field> > > >
+    FrozenHull<Field>::get_tangents_batch(std::span< Point<Field> const > points, unsigned threads) const {
+      std::vector< std::optional< std::pair< Point<Field>, Point<Field> > > > tangents(points.size());
+      __for_blocks(points.size(), threads, [&](std::size_t first, std::size_t last) {
+          if( get_hull_size() >= search_lanes_from )
+            return __get_tangents_lanes(points.data() + first, last - first, tangents.data() + first);
+          std::vector< uint8_t > inside(last - first);
+          if( get_hull_size() > 2 ) __point_in_polygon_lanes(points.data() + first, last - first, inside.data());
+          for(auto i = first; i < last; i++)
+            if( not inside[i - first] ) tangents[i] = get_tangents(points[i]);
+          });
+      return tangents;
+    }
+
+  template<typename Field> bool FrozenHull<Field>::point_in_polygon(Point<Field> const& point) const {
+    return __point_in_polygon(lower_hull, upper_hull, point);
+  }
+
+  template<typename Field> std::optional< std::pair< Point<Field>, Point<Field> > >
+    FrozenHull<Field>::get_tangents (Point<Field> const& point) const {
+      return __get_tangents(lower_hull, upper_hull, point, get_hull_size());
+    }
+
+  template<typename Field> std::pair< Point<Field>, Point<Field> >
+    FrozenHull<Field>::get_extremal_points (Point<Field> const& direction) const {
+      return __get_extremal_points(lower_hull, upper_hull, direction);
+    }
+
+  template<typename Field> std::vector< std::pair< Point<Field>, Point<Field> > >
+    FrozenHull<Field>::get_extremal_points_batch (std::span< Point<Field> const > directions) const {
+      std::vector< std::pair< Point<Field>, Point<Field> > > extremes(directions.size());
+      __get_extremal_points_batch< Field >(lower_hull, upper_hull, directions, std::span(extremes));
+      return extremes;
+    }
+
+  template<typename Field> template<typename Callback>
+    void FrozenHull<Field>::traverse_lower_hull(Callback const& callback) const {
+      for(auto const& segment: lower_hull.segments) callback(segment);
+    }
+
+  template<typename Field> template<typename Callback>
+    void FrozenHull<Field>::traverse_upper_hull(Callback const& callback) const {
+      for(auto const& segment: upper_hull.segments) callback(segment);
+    }
+
+}; // end namespace dpch
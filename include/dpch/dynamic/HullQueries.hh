@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <span>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/util/ForkJoin.hh>
+#include <dpch/static/RadixSort.hh>
+
+namespace dpch {
+
+  /* Point in polygon, tangent and farthest point queries over a lower and an upper
+   * chain of segments, each offering begin(), rbegin(), end() and a binary_search()
+   * for the first segment satisfying a monotone predicate on segment iterators.
+   * Orientations are evaluated by the predicates of util/Predicates.hh. An empty hull
+   * encloses nothing and has no tangents; extremal points need a nonempty hull. */
+
+  template<typename Field, typename LowerHull, typename UpperHull> bool __point_in_polygon(
+      LowerHull const& lower_hull, UpperHull const& upper_hull, Point<Field> const& point) {
+    auto const lower_segment = lower_hull.binary_search(
+        [&](auto const& seg) { return point < seg->v; });
+    auto const upper_segment = upper_hull.binary_search(
+        [&](auto const& seg) { return point < seg->v; });
+
+    bool lower_enclosed = lower_segment != lower_hull.end() and
+      orientation(lower_segment->u, lower_segment->v, point) > 0;
+    bool upper_enclosed = upper_segment != upper_hull.end() and
+      orientation(upper_segment->u, upper_segment->v, point) < 0;
+
+    return lower_enclosed and upper_enclosed;
+  }
+
+  template<typename Field, typename LowerHull, typename UpperHull>
+    std::optional< std::pair< Point<Field>, Point<Field> > > __get_tangents(
+        LowerHull const& lower_hull, UpperHull const& upper_hull, Point<Field> const& point, int32_t hull_size) {
+      if( lower_hull.begin() == lower_hull.end() ) return {};
+      if( hull_size <= 2 ) {
+        auto ret = *(lower_hull.begin());
+        return {{ret.u, ret.v}};
+      }
+
+      auto first = lower_hull.begin()->u, last = upper_hull.rbegin()->v;
+
+      if( point < first ) {
+        auto lower_segment = lower_hull.binary_search([&](auto const& seg)
+            { return orientation(seg->u, seg->v, point) > 0;});
+        auto lower_tangent = lower_segment == lower_hull.end() ? last : lower_segment->u;
+
+        auto upper_segment = upper_hull.binary_search([&](auto const& seg)
+            { return orientation(seg->u, seg->v, point) < 0;});
+        auto upper_tangent = upper_segment == upper_hull.end() ? last : upper_segment->u;
+
+        if( upper_tangent < lower_tangent ) std::swap(upper_tangent, lower_tangent);
+        return {{lower_tangent, upper_tangent}};
+      } else if( last < point ) {
+        auto lower_segment = lower_hull.binary_search([&](auto const& seg)
+            { return orientation(seg->u, seg->v, point) <= 0;});
+        auto lower_tangent = lower_segment == lower_hull.end() ? last : lower_segment->u;
+
+        auto upper_segment = upper_hull.binary_search([&](auto const& seg)
+            { return orientation(seg->u, seg->v, point) >= 0;});
+        auto upper_tangent = upper_segment == upper_hull.end() ? last : upper_segment->u;
+
+        if( upper_tangent < lower_tangent ) std::swap(upper_tangent, lower_tangent);
+        return {{lower_tangent, upper_tangent}};
+      } else {
+        auto const lower_segment = lower_hull.binary_search(
+            [&](auto const& seg) { return point < seg->v; });
+        auto const upper_segment = upper_hull.binary_search(
+            [&](auto const& seg) { return point < seg->v; });
+
+        bool lower_enclosed = lower_segment != lower_hull.end() and
+          orientation(lower_segment->u, lower_segment->v, point) > 0;
+        bool upper_enclosed = upper_segment != upper_hull.end() and
+          orientation(upper_segment->u, upper_segment->v, point) < 0;
+
+        if( lower_enclosed and upper_enclosed ) return {};
+
+        if( lower_enclosed ) { // => not upper_enclosed
+          auto left_segment = upper_hull.binary_search(
+              [&](auto const& seg)
+              { return point < seg->v or orientation(seg->u, seg->v, point) >= 0; });
+          auto left_tangent = left_segment == upper_hull.end() ? first : left_segment->u;
+
+          auto right_segment = upper_hull.binary_search(
+              [&](auto const& seg)
+              { return point < seg->u and orientation(seg->u, seg->v, point) < 0; });
+          auto right_tangent =
+            right_segment == upper_hull.end() ? last : right_segment->u;
+
+          if( right_tangent < left_tangent ) std::swap(left_tangent, right_tangent);
+          return {{left_tangent, right_tangent}};
+        } else { 
+          auto left_segment = lower_hull.binary_search(
+              [&](auto const& seg)
+              { return point < seg->v or orientation(seg->u, seg->v, point) <= 0; });
+          auto left_tangent = left_segment == lower_hull.end() ? first : left_segment->u;
+
+          auto right_segment = lower_hull.binary_search(
+              [&](auto const& seg)
+              { return point < seg->u and orientation(seg->u, seg->v, point) > 0; });
+          auto right_tangent =
+            right_segment == lower_hull.end() ? last : right_segment->u;
+
+          if( right_tangent < left_tangent ) std::swap(left_tangent, right_tangent);
+          return {{left_tangent, right_tangent}};
+        }
+      }
+
+      return {}; // never occurs
+    }
+
+  /* The farthest points in direction on the first segment whose projection on it is
+   * not positive: both ends when it is perpendicular to direction. */
+  template<typename Field> inline std::pair< Point<Field>, Point<Field> >
+    __extremal_points(LineSegment<Field> segment, Point<Field> const& direction) {
+      if( projection(segment.u, segment.v, direction) < 0 ) segment.v = segment.u;
+      if( projection(segment.v, segment.u, direction) < 0 ) segment.u = segment.v;
+      return {segment.u, segment.v};
+    }
+
+  template<typename Field, typename LowerHull, typename UpperHull> std::pair< Point<Field>, Point<Field> >
+    __get_extremal_points(LowerHull const& lower_hull, UpperHull const& upper_hull, Point<Field> const& direction) {
+
+      auto first = lower_hull.begin()->u, last = upper_hull.rbegin()->v;
+
+      LineSegment<Field> segment{first, last};
+      if( direction.y > 0 or (direction.y == 0 and direction.x < 0) ) {
+        auto udip = [&direction](auto const& seg)
+        { return projection(seg->u, seg->v, direction) <= 0; };
+        auto seg = upper_hull.binary_search(udip);
+        if( seg != upper_hull.end() ) segment = *seg;
+      } else {
+        auto ldip = [&direction](auto const& seg)
+        { return projection(seg->u, seg->v, direction) <= 0; };
+        auto seg = lower_hull.binary_search(ldip);
+        if( seg != lower_hull.end() ) segment = *seg;
+      }
+
+      return __extremal_points(segment, direction);
+    }
+
+  /* Splits the indices of the nonzero directions into those searched on the upper chain
+   * and those searched on the lower chain, each sorted so that the segment the search
+   * finds moves left to right: clockwise from pointing left on the upper chain, and
+   * counterclockwise from there on the lower chain. On either half-plane that is the
+   * order of x / (|x| + |y|); directions are radix sorted by that ratio rounded to 32
+   * bits, and an insertion sort by orientation then orders those the rounding tied or
+   * swapped. Returns the indices of the zero directions. */
+  template<typename Field> std::vector< size_t > __sort_directions(std::span< Point<Field> const > directions,
+      std::vector< size_t >& upper, std::vector< size_t >& lower) {
+    assert(directions.size() <= UINT32_MAX);
+    std::vector< size_t > zero;
+    std::vector< Point<uint32_t> > upper_keys, lower_keys; // (key, index)
+    Point<Field> const origin(0, 0);
+    for(size_t i = 0; i < directions.size(); i++) {
+      auto const& direction = directions[i];
+      if( direction == origin ) { zero.push_back(i); continue; }
+      double x = double(direction.x), y = double(direction.y);
+      Point<uint32_t> key(uint32_t(std::min(std::ldexp(x / (std::abs(x) + std::abs(y)) + 1, 31), double(UINT32_MAX))), i);
+      if( direction.y > 0 or (direction.y == 0 and direction.x < 0) ) upper_keys.push_back(key);
+      else lower_keys.push_back(key);
+    }
+
+    ForkJoin pool(1);
+    auto sort = [&](std::vector< Point<uint32_t> >& keys, std::vector< size_t >& order, auto const& before) {
+      radix_sort(std::span(keys), pool);
+      order.reserve(keys.size());
+      for(auto const& key: keys) {
+        order.push_back(key.y);
+        for(auto j = order.size() - 1; j > 0 and before(order[j], order[j - 1]); j--) std::swap(order[j], order[j - 1]);
+      }
+    };
+    sort(upper_keys, upper, [&](size_t a, size_t b) { return orientation(origin, directions[b], directions[a]) > 0; });
+    sort(lower_keys, lower, [&](size_t a, size_t b) { return orientation(origin, directions[a], directions[b]) > 0; });
+    return zero;
+  }
+
+  /* Whether k directions on a hull of h segments are worth sorting. A batch descent
+   * visits O(k log(h/k)) nodes instead of O(k log h) but, one path after the other, does
+   * not overlap cache misses the way independent searches do, and the sort costs a few
+   * node visits per direction: it pays off on hulls that outgrow the cache, for
+   * directions numbering a sizeable fraction of the hull. */
+  inline bool __sweep_directions(size_t k, size_t h) { return h >= 4096 and 4 * k >= h; }
+
+  /* __get_extremal_points for many directions, into extremes[i] for directions[i]. The
+   * directions are sorted by angle, and each chain searched for all of its directions
+   * at once through a batch_search(n, predicate, callback) walking the union of their
+   * search paths, each node once; a search path shares its top with the previous one,
+   * so that k directions cost O(k) to sort and O(k log(h/k)) nodes to search instead
+   * of O(k log h). */
+  template<typename Field, typename LowerHull, typename UpperHull> void __get_extremal_points_batch(
+      LowerHull const& lower_hull, UpperHull const& upper_hull, std::span< Point<Field> const > directions,
+      std::span< std::pair< Point<Field>, Point<Field> > > extremes) {
+    assert(extremes.size() == directions.size());
+    if( not __sweep_directions(directions.size(), size_t(lower_hull.get_size() + upper_hull.get_size())) ) {
+      for(size_t i = 0; i < directions.size(); i++) extremes[i] = __get_extremal_points(lower_hull, upper_hull, directions[i]);
+      return;
+    }
+    std::vector< size_t > upper, lower;
+    for(auto i: __sort_directions(directions, upper, lower))
+      extremes[i] = __get_extremal_points(lower_hull, upper_hull, directions[i]);
+
+    LineSegment<Field> const whole{lower_hull.begin()->u, upper_hull.rbegin()->v};
+    auto search = [&](auto const& chain, std::vector< size_t > const& order) {
+      chain.batch_search(order.size(),
+          [&](auto const& seg, size_t k) { return projection(seg->u, seg->v, directions[order[k]]) <= 0; },
+          [&](size_t k, auto const& seg) {
+            extremes[order[k]] = __extremal_points(seg == chain.end() ? whole : *seg, directions[order[k]]);
+          });
+    };
+    search(upper_hull, upper);
+    search(lower_hull, lower);
+  }
+
+}; // end namespace dpch
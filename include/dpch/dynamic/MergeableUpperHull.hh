@@ -2,11 +2,16 @@
 
 #include <dpch/util/Point.hh>
 #include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
 #include <dpch/dynamic/DynamicArray.hh>
 
 namespace dpch {
 
-  template<typename Field> class MergeableUpperHull : public DynamicArray<LineSegment<Field>> {
+  template<typename Field, typename Summary = ArraySummary< LineSegment<Field> >>
+    class MergeableUpperHull : public DynamicArray<LineSegment<Field>, Summary> {
+    public:
+    using DynamicArray<LineSegment<Field>, Summary>::DynamicArray;
+
     friend LineSegment<Field>
       find_upper_bridge<>(MergeableUpperHull const& left, MergeableUpperHull const& right);
 
@@ -19,43 +24,42 @@ namespace dpch {
         MergeableUpperHull &left_residual, MergeableUpperHull &right_residual);
   };
 
-  template<typename Field> LineSegment<Field> find_upper_bridge(
-      MergeableUpperHull<Field> const& left, MergeableUpperHull<Field> const& right) {
+  template<typename Field, typename Summary> LineSegment<Field> find_upper_bridge(
+      MergeableUpperHull<Field, Summary> const& left, MergeableUpperHull<Field, Summary> const& right) {
+    auto const nil = MergeableUpperHull<Field, Summary>::nil;
+    // the hulls may live in different arenas
+    auto const& lnodes = *left.arena, &rnodes = *right.arena;
     auto lpt = left.treap, rpt = right.treap;
     auto split_x = right.begin()->u.x;
-    LineSegment<Field> left_cur = lpt->element, right_cur = rpt->element;
+    LineSegment<Field> left_cur = lnodes[lpt].element, right_cur = rnodes[rpt].element;
 
     auto ccw = [](Point<Field> const& pivot,
         Point<Field> const&first, Point<Field> const& second)
-    { return ((first - pivot) * (second - pivot)) >= 0; };
+    { return orientation(pivot, first, second) >= 0; };
 
+    DPCH_COUNT(bridges);
     auto lseg = left_cur.u != left_cur.v, rseg = right_cur.u != right_cur.v;
     while( lseg or rseg ) {
+      DPCH_COUNT(bridge_steps);
       if( lseg and ccw(left_cur.u, left_cur.v, right_cur.u) ) {
-        lpt = lpt->left;
-        if( lpt == nullptr ) left_cur.v = left_cur.u; else left_cur = lpt->element;
+        lpt = lnodes[lpt].left;
+        if( lpt == nil ) left_cur.v = left_cur.u; else left_cur = lnodes[lpt].element;
       } else if( rseg and ccw(left_cur.v, right_cur.u, right_cur.v) ) {
-        rpt = rpt->right;
-        if( rpt == nullptr ) right_cur.u = right_cur.v; else right_cur = rpt->element;
+        rpt = rnodes[rpt].right;
+        if( rpt == nil ) right_cur.u = right_cur.v; else right_cur = rnodes[rpt].element;
       } else if ( not lseg ) { // => ccw0(lv, ru, rv);
-        rpt = rpt->left;
-        if( rpt == nullptr ) right_cur.v = right_cur.u; else right_cur = rpt->element;
+        rpt = rnodes[rpt].left;
+        if( rpt == nil ) right_cur.v = right_cur.u; else right_cur = rnodes[rpt].element;
       } else if ( not rseg ) { // => ccw0(lu, lv, ru);
-        lpt = lpt->right;
-        if( lpt == nullptr ) left_cur.u = left_cur.v; else left_cur = lpt->element;
+        lpt = lnodes[lpt].right;
+        if( lpt == nil ) left_cur.u = left_cur.v; else left_cur = lnodes[lpt].element;
       } else {
-        auto dl  = left_cur.v - left_cur.u, dr = right_cur.u - right_cur.v;
-        auto tlx = (split_x - left_cur.u.x), trx = (split_x - right_cur.v.x);
-        // if( left_cur.u.y + tlx * dl.y / dl.x <= right_cur.v.y +trx * dr.y / dr.x )
-        auto lhs = dr.x * (dl.x * left_cur.u.y + tlx * dl.y),
-             rhs = dl.x * (dr.x * right_cur.v.y + trx * dr.y);
-        if( dr.x * dl.x <= 0 ) lhs = -lhs, rhs = -rhs;
-        if( lhs > rhs ) { // don't change this to equality
-          lpt = lpt->right;
-          if( lpt == nullptr ) left_cur.u = left_cur.v; else left_cur = lpt->element;
+        if( split_order(left_cur, right_cur, split_x) > 0 ) { // don't change this to equality
+          lpt = lnodes[lpt].right;
+          if( lpt == nil ) left_cur.u = left_cur.v; else left_cur = lnodes[lpt].element;
         } else {
-          rpt = rpt->left;
-          if( rpt == nullptr ) right_cur.v = right_cur.u; else right_cur = rpt->element;
+          rpt = rnodes[rpt].left;
+          if( rpt == nil ) right_cur.v = right_cur.u; else right_cur = rnodes[rpt].element;
         }
       }
       lseg = left_cur.u != left_cur.v, rseg = right_cur.u != right_cur.v;
@@ -64,44 +68,45 @@ namespace dpch {
   }
 
 
-  template<typename Field> LineSegment<Field> merge_upper_hulls(MergeableUpperHull<Field> &merged,
-      MergeableUpperHull<Field> &left, MergeableUpperHull<Field> &right,
-      MergeableUpperHull<Field> &left_residual, MergeableUpperHull<Field> &right_residual) {
+  template<typename Field, typename Summary> LineSegment<Field> merge_upper_hulls(MergeableUpperHull<Field, Summary> &merged,
+      MergeableUpperHull<Field, Summary> &left, MergeableUpperHull<Field, Summary> &right,
+      MergeableUpperHull<Field, Summary> &left_residual, MergeableUpperHull<Field, Summary> &right_residual) {
     auto bridge = find_upper_bridge(left, right);
-    MergeableUpperHull<Field>::cut( [&](MergeableUpperHull<Field>::iterator const&it)
+    MergeableUpperHull<Field, Summary>::cut( [&](MergeableUpperHull<Field, Summary>::iterator const&it)
         { return not (it->u < bridge.u);}, left, left, left_residual);
-    MergeableUpperHull<Field>::cut( [&](MergeableUpperHull<Field>::iterator const&it)
+    MergeableUpperHull<Field, Summary>::cut( [&](MergeableUpperHull<Field, Summary>::iterator const&it)
         { return bridge.v < it->v; }, right, right_residual, right);
-    MergeableUpperHull<Field>::join(merged, left, MergeableUpperHull<Field>(bridge));
-    MergeableUpperHull<Field>::join(merged, merged, right);
+    MergeableUpperHull<Field, Summary>::join(merged, left, MergeableUpperHull<Field, Summary>(bridge, *left.arena));
+    MergeableUpperHull<Field, Summary>::join(merged, merged, right);
+    left = right = MergeableUpperHull<Field, Summary>(); // consumed into merged
     return bridge;
   }
 
 
-  template<typename Field> void split_upper_hulls(LineSegment<Field> const& bridge, MergeableUpperHull<Field> &merged,
-      MergeableUpperHull<Field> &left, MergeableUpperHull<Field> &right,
-      MergeableUpperHull<Field> &left_residual, MergeableUpperHull<Field> &right_residual) {
-    MergeableUpperHull<Field> bt;
-    MergeableUpperHull<Field>::cut( [&](MergeableUpperHull<Field>::iterator const&it)
+  template<typename Field, typename Summary> void split_upper_hulls(LineSegment<Field> const& bridge, MergeableUpperHull<Field, Summary> &merged,
+      MergeableUpperHull<Field, Summary> &left, MergeableUpperHull<Field, Summary> &right,
+      MergeableUpperHull<Field, Summary> &left_residual, MergeableUpperHull<Field, Summary> &right_residual) {
+    MergeableUpperHull<Field, Summary> bt;
+    MergeableUpperHull<Field, Summary>::cut( [&](MergeableUpperHull<Field, Summary>::iterator const&it)
         { return bridge.v < it->v; }, merged, left, right);
-    MergeableUpperHull<Field>::cut( [&](MergeableUpperHull<Field>::iterator const&it)
+    MergeableUpperHull<Field, Summary>::cut( [&](MergeableUpperHull<Field, Summary>::iterator const&it)
         { return bridge.u < it->v; }, left, left, bt);
     // assert(bt.get_size() == 0 or bt.get_size() == 1 and *(bt._begin)==bridge);
     bt.destroy(); // deallocate memory
-    MergeableUpperHull<Field>::join(left, left, left_residual);
-    MergeableUpperHull<Field>::join(right, right_residual, right);
+    MergeableUpperHull<Field, Summary>::join(left, left, left_residual);
+    MergeableUpperHull<Field, Summary>::join(right, right_residual, right);
+    merged = left_residual = right_residual = MergeableUpperHull<Field, Summary>(); // consumed
   }
 
 
-  template<typename Field> bool is_concave(MergeableUpperHull<Field> const& seq) {
-    if( seq.begin() == seq.end() ) return true;
-    for(auto it = seq.begin();; ++it) {
-      auto jt = it; ++jt;
-      if( jt == seq.end() ) break;
-      auto u = it->u, v = it->v, w = jt->v;
-      if( ((v-u)*(w-u)) > 0 ) return false;
-    }
-    return true;
+  template<typename Field, typename Summary> bool is_concave(MergeableUpperHull<Field, Summary> const& seq) {
+    bool ret = true, first = true;
+    LineSegment<Field> last;
+    seq.traverse([&](LineSegment<Field> const& seg) {
+      if( not first and orientation(last.u, last.v, seg.v) > 0 ) ret = false;
+      first = false, last = seg;
+    });
+    return ret;
   };
 
 }; // end namespace dpch
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <dpch/util/ForkJoin.hh>
+#include <dpch/util/Priorities.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/HullQueries.hh>
+
+namespace dpch {
+
+  /* A hull split into shards by x, each shard a DynamicHull with a lock of its own, so
+   * that writers on different shards never wait for each other. merge() pins a fork of
+   * every shard and combines the root chains of the forks into global chains, without
+   * copying them: runs of shard chains joined by the bridges find_{lower,upper}_bridge
+   * computes between shards, O(k^2 log n) for k shards. It first moves the shard
+   * boundaries to the quantiles of x when the largest shard has grown to twice its fair
+   * share, moving points with apply_batch. Queries search the runs, O(k log n). Updates
+   * after a merge copy the nodes they share with the pinned forks, which are let go at
+   * the next merge. */
+  template<typename Field> class ShardedDynamicHull {
+
+    public :
+
+      using size_t = int32_t;
+
+      using lower_hull_t = MergeableLowerHull<Field>;
+      using upper_hull_t = MergeableUpperHull<Field>;
+
+      template<typename Hull> class Chain;
+
+      explicit ShardedDynamicHull(size_t shards, uint64_t seed = Priorities::default_seed);
+      ShardedDynamicHull(ShardedDynamicHull const&) = delete;
+      ShardedDynamicHull& operator=(ShardedDynamicHull const&) = delete;
+
+      /* Writers; updates of points in different shards run in parallel. */
+      void add_point(Point<Field> const&);
+      bool remove_point(Point<Field> const&);
+
+      /* Exclusive of every other call. apply_batch updates shards in parallel and merges. */
+      size_t apply_batch(std::span< Point<Field> const > inserts,
+          std::span< Point<Field> const > deletes, unsigned threads = 1);
+      void merge(unsigned threads = 1);
+      void rebalance(unsigned threads = 1);
+
+      /* Queries see the points as of the last merge(); updates since then are not seen
+       * until the next one. */
+      bool point_in_polygon(Point<Field> const&) const;
+
+      std::optional< std::pair< Point<Field>, Point<Field> > >
+        get_tangents (Point<Field> const&) const;
+
+      /* The hull must not be empty. */
+      std::pair< Point<Field>, Point<Field> >
+        get_extremal_points(Point<Field> const&) const;
+
+      template<typename Callback> void traverse_lower_hull(Callback const& callback) const
+      { lower_hull.traverse(callback); }
+      template<typename Callback> void traverse_upper_hull(Callback const& callback) const
+      { upper_hull.traverse(callback); }
+
+      size_t get_lower_hull_size() const { return lower_hull.get_size(); }
+      size_t get_upper_hull_size() const { return upper_hull.get_size(); }
+      size_t get_hull_size() const { return get_lower_hull_size() + get_upper_hull_size(); }
+
+      size_t get_num_points() const;
+      size_t get_num_shards() const { return size_t(shards.size()); }
+      size_t get_shard_size(size_t shard) const { return shards[shard]->hull.get_num_points(); }
+
+      /* Whether no update came since the last merge(). */
+      bool is_merged() const { return not dirty; }
+
+    private:
+      struct Shard {
+        DynamicHull<Field> hull;
+        DynamicHull<Field> pinned; // the fork of hull the global chains are made of
+        std::mutex mutex;
+      };
+
+      std::vector< std::unique_ptr<Shard> > shards;
+      std::vector< Field > boundaries; // shard i holds the points with boundaries[i-1] <= x < boundaries[i]
+      std::atomic<bool> dirty = false;
+      size_t rebalanced_size = 0;      // size of the largest shard after the last rebalance
+
+      size_t shard_of(Point<Field> const& point) const {
+        return size_t(std::upper_bound(boundaries.begin(), boundaries.end(), point.x) - boundaries.begin());
+      }
+
+      Chain<lower_hull_t> lower_hull;
+      Chain<upper_hull_t> upper_hull;
+
+      template<typename Hull, typename Bridge> void merge_chain(Chain<Hull>&,
+          Hull const& (DynamicHull<Field>::*)() const, Bridge const&, int);
+  };
+
+  /* A chain made of runs of shard chains, from vertex lo to vertex hi, each but the first
+   * entered by a bridge from the previous one, with the interface HullQueries expects. */
+  template<typename Field> template<typename Hull> class ShardedDynamicHull<Field>::Chain {
+    public:
+      /* Holds a copy of the segment it points to; all past-the-end iterators are equal. */
+      class iterator {
+        public:
+          iterator() = default;
+          explicit iterator(LineSegment<Field> const& _segment) : segment(_segment), valid(true) { }
+
+          LineSegment<Field> const& operator*() const { return segment; }
+          LineSegment<Field> const* operator->() const { return &segment; }
+
+          friend bool operator== (iterator const& a, iterator const& b) {
+            return a.valid == b.valid and (not a.valid or (a.segment.u == b.segment.u and a.segment.v == b.segment.v));
+          }
+          friend bool operator!= (iterator const& a, iterator const& b) { return not (a == b); }
+
+        private:
+          LineSegment<Field> segment;
+          bool valid = false;
+      };
+
+      iterator begin() const { return binary_search([](auto const&) { return true; }); }
+      iterator end() const { return iterator(); }
+      iterator rbegin() const {
+        auto const& run = runs.back();
+        return run.size == 0 ? iterator(run.bridge) : last(run);
+      }
+
+      template<typename Predicate> iterator binary_search(Predicate const&) const;
+      template<typename Callback> void traverse(Callback const&) const;
+
+      size_t get_size() const {
+        size_t size = runs.empty() ? 0 : size_t(runs.size()) - 1;
+        for(auto const& run: runs) size += run.size;
+        return size;
+      }
+
+    private:
+      friend class ShardedDynamicHull;
+
+      struct Run {
+        Hull const* hull;
+        Point<Field> lo, hi;
+        LineSegment<Field> bridge;
+        size_t size = 0;
+      };
+
+      std::vector< Run > runs;
+
+      iterator last(Run const& run) const {
+        return iterator(*run.hull->binary_search([&](auto const& seg) { return not (seg->v < run.hi); }));
+      }
+  };
+
+  template<typename Field> template<typename Hull> template<typename Predicate>
+    typename ShardedDynamicHull<Field>::template Chain<Hull>::iterator
+    ShardedDynamicHull<Field>::Chain<Hull>::binary_search(Predicate const& predicate) const {
+      for(size_t r = 0; r < size_t(runs.size()); r++) {
+        auto const& run = runs[r];
+        if( r > 0 and predicate(iterator(run.bridge)) ) return iterator(run.bridge);
+        if( run.size == 0 or not predicate(last(run)) ) continue;
+        return iterator(*run.hull->binary_search([&](auto const& seg)
+            { return run.hi < seg->v or (not (seg->u < run.lo) and predicate(seg)); }));
+      }
+      return end();
+    }
+
+  template<typename Field> template<typename Hull> template<typename Callback>
+    void ShardedDynamicHull<Field>::Chain<Hull>::traverse(Callback const& callback) const {
+      for(size_t r = 0; r < size_t(runs.size()); r++) {
+        auto const& run = runs[r];
+        if( r > 0 ) callback(run.bridge);
+        if( run.size == 0 ) continue;
+        run.hull->traverse([&](LineSegment<Field> const& seg)
+            { if( not (seg.u < run.lo) and not (run.hi < seg.v) ) callback(seg); });
+      }
+    }
+
+  template<typename Field>
+    ShardedDynamicHull<Field>::ShardedDynamicHull(size_t n_shards, uint64_t seed)
+    : boundaries(n_shards - 1, std::numeric_limits<Field>::max()) {
+      assert( n_shards >= 1 );
+      for(size_t i = 0; i < n_shards; i++) {
+        shards.push_back(std::make_unique<Shard>());
+        shards.back()->hull.seed(seed + i);
+      }
+    }
+
+  template<typename Field> void ShardedDynamicHull<Field>::add_point(Point<Field> const& point) {
+    auto& shard = *shards[shard_of(point)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.hull.add_point(point);
+    dirty = true;
+  }
+
+  template<typename Field> bool ShardedDynamicHull<Field>::remove_point(Point<Field> const& point) {
+    auto& shard = *shards[shard_of(point)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    dirty = true;
+    return shard.hull.remove_point(point);
+  }
+
+  template<typename Field> ShardedDynamicHull<Field>::size_t ShardedDynamicHull<Field>::apply_batch(
+      std::span< Point<Field> const > inserts, std::span< Point<Field> const > deletes, unsigned threads) {
+    std::vector< std::vector< Point<Field> > > shard_inserts(shards.size()), shard_deletes(shards.size());
+    for(auto const& point: inserts) shard_inserts[shard_of(point)].push_back(point);
+    for(auto const& point: deletes) shard_deletes[shard_of(point)].push_back(point);
+
+    std::atomic< size_t > removed = 0;
+    ForkJoin pool(threads);
+    parallel_for(pool, 0, shards.size(), [&](std::size_t i) {
+      if( shard_inserts[i].empty() and shard_deletes[i].empty() ) return;
+      removed += shards[i]->hull.apply_batch(shard_inserts[i], shard_deletes[i]);
+    });
+    dirty = true;
+    merge(threads);
+    return removed;
+  }
+
+  template<typename Field> ShardedDynamicHull<Field>::size_t ShardedDynamicHull<Field>::get_num_points() const {
+    size_t num_points = 0;
+    for(auto const& shard: shards) num_points += shard->hull.get_num_points();
+    return num_points;
+  }
+
+  /* Boundaries move to the quantiles of x, and the points on the wrong side of them
+   * are moved over in one batch per shard. */
+  template<typename Field> void ShardedDynamicHull<Field>::rebalance(unsigned threads) {
+    std::vector< Field > xs;
+    xs.reserve(get_num_points());
+    for(auto const& shard: shards) shard->hull.traverse_set([&](Point<Field> const& point) { xs.push_back(point.x); });
+    if( xs.empty() ) return;
+    std::sort(xs.begin(), xs.end());
+    auto old_boundaries = boundaries;
+    for(size_t i = 1; i < get_num_shards(); i++) boundaries[i - 1] = xs[xs.size() * i / shards.size()];
+
+    std::vector< std::vector< Point<Field> > > shard_inserts(shards.size()), shard_deletes(shards.size());
+    for(size_t i = 0; i < get_num_shards(); i++) {
+      shards[i]->hull.traverse_set([&](Point<Field> const& point) {
+        auto target = shard_of(point);
+        if( target != i ) shard_deletes[i].push_back(point), shard_inserts[target].push_back(point);
+      });
+    }
+    ForkJoin pool(threads);
+    parallel_for(pool, 0, shards.size(), [&](std::size_t i) {
+      if( shard_inserts[i].empty() and shard_deletes[i].empty() ) return;
+      shards[i]->hull.apply_batch(shard_inserts[i], shard_deletes[i]);
+    });
+
+    rebalanced_size = 0;
+    for(size_t i = 0; i < get_num_shards(); i++) rebalanced_size = std::max(rebalanced_size, get_shard_size(i));
+    dirty = true;
+  }
+
+  template<typename Field> void ShardedDynamicHull<Field>::merge(unsigned threads) {
+    size_t largest = 0;
+    for(size_t i = 0; i < get_num_shards(); i++) largest = std::max(largest, get_shard_size(i));
+    if( largest > 2 * std::max(get_num_points() / get_num_shards(), rebalanced_size) + 16 ) rebalance(threads);
+
+    // the old fork goes first, so that the shard is left alone in its nodes until the next update
+    for(auto& shard: shards) shard->pinned = DynamicHull<Field>(), shard->pinned = shard->hull.fork();
+
+    merge_chain(lower_hull, &DynamicHull<Field>::get_lower_hull,
+        [](lower_hull_t const& left, lower_hull_t const& right) { return find_lower_bridge(left, right); }, 1);
+    merge_chain(upper_hull, &DynamicHull<Field>::get_upper_hull,
+        [](upper_hull_t const& left, upper_hull_t const& right) { return find_upper_bridge(left, right); }, -1);
+    dirty = false;
+  }
+
+  /* Adds shards from left to right. The bridge from the chain so far to the next shard
+   * is the common tangent of that shard and one of the runs; tangents of the same shard
+   * from below compare by slope, and the steepest, the one that passes below the contact
+   * points of all others, wins (the flattest from above). The winning run keeps its part
+   * up to the bridge, and the runs after it are dropped. On ties the leftmost contact
+   * wins, so that no vertex is collinear with its neighbours. */
+  template<typename Field> template<typename Hull, typename Bridge>
+    void ShardedDynamicHull<Field>::merge_chain(Chain<Hull>& chain,
+        Hull const& (DynamicHull<Field>::*get_chain)() const, Bridge const& find_bridge, int side) {
+      auto& runs = chain.runs;
+      runs.clear();
+      for(auto const& shard: shards) {
+        if( shard->pinned.get_num_points() == 0 ) continue;
+        Hull const& next = (shard->pinned.*get_chain)();
+        if( runs.empty() ) {
+          runs.push_back({&next, next.begin()->u, next.rbegin()->v, LineSegment<Field>()});
+          continue;
+        }
+        size_t best = size_t(runs.size()) - 1;
+        auto bridge = find_bridge(*runs[best].hull, next);
+        for(size_t r = best; r-- > 0; ) {
+          auto candidate = find_bridge(*runs[r].hull, next);
+          auto turn = orientation(bridge.u, bridge.v, candidate.u);
+          if( (side > 0 and turn < 0) or (side < 0 and turn > 0) or (turn == 0 and candidate.u < bridge.u) )
+            best = r, bridge = candidate;
+        }
+        runs.resize(best + 1);
+        runs[best].hi = bridge.u;
+        runs.push_back({&next, bridge.v, next.rbegin()->v, bridge});
+      }
+
+      for(auto& run: runs) {
+        if( runs.size() > 1 and run.lo == run.hi ) { run.size = 0; continue; }
+        run.size = run.hull->rank([&](auto const& seg) { return run.hi < seg->v; }) -
+          run.hull->rank([&](auto const& seg) { return not (seg->u < run.lo); });
+      }
+    }
+
+  /* Point in polygon, tangent and farthest point queries. */
+
+  template<typename Field> bool ShardedDynamicHull<Field>::point_in_polygon(Point<Field> const& point) const {
+    return __point_in_polygon(lower_hull, upper_hull, point);
+  }
+
+  template<typename Field> std::optional< std::pair< Point<Field>, Point<Field> > >
+    ShardedDynamicHull<Field>::get_tangents (Point<Field> const& point) const {
+        return __get_tangents(lower_hull, upper_hull, point, get_hull_size());
+    }
+
+  template<typename Field> std::pair< Point<Field>, Point<Field> >
+    ShardedDynamicHull<Field>::get_extremal_points (Point<Field> const& direction) const {
+        return __get_extremal_points(lower_hull, upper_hull, direction);
+    }
+
+}; // end namespace dpch
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/util/Priorities.hh>
+#include <dpch/dynamic/DynamicArray.hh>
+#include <dpch/dynamic/MergeableLowerHull.hh>
+#include <dpch/dynamic/MergeableUpperHull.hh>
+#include <dpch/dynamic/HullQueries.hh>
+
+namespace dpch {
+
+  /* The hull of the last capacity points of a stream, as a queue made of two stacks
+   * of points, each with its own pair of chains. New points are inserted into the
+   * chains of the back stack. The oldest point is the top of the front stack, whose
+   * chains were built by inserting points from the newest to the oldest while keeping
+   * the segments each insertion replaced: evicting it undoes its insertion. When the
+   * front stack runs out, the back stack is moved over. Every point is inserted twice
+   * and undone once, a few cuts and joins each, so a sample costs O(log n) amortized,
+   * with an O(n log n) step every n samples. Queries combine both hulls. */
+  template<typename Field> class SlidingWindowHull {
+
+    public :
+
+      using size_t = int32_t;
+
+      using lower_hull_t = MergeableLowerHull<Field>;
+      using upper_hull_t = MergeableUpperHull<Field>;
+
+      /* Equal seeds and equal streams give equal trees. */
+      explicit SlidingWindowHull(size_t capacity, uint64_t seed = Priorities::default_seed);
+      SlidingWindowHull(SlidingWindowHull const&) = delete;
+      SlidingWindowHull& operator=(SlidingWindowHull const&) = delete;
+      SlidingWindowHull(SlidingWindowHull&&) = default;
+      SlidingWindowHull& operator=(SlidingWindowHull&&) = default;
+
+      /* Appends a point, evicting the oldest one first when the window is full. */
+      void add_point(Point<Field> const&);
+      void remove_oldest_point();
+      Point<Field> const& get_oldest_point() const;
+
+      /* Queries need at least one point in the window. */
+      bool point_in_polygon(Point<Field> const&) const;
+
+      std::optional< std::pair< Point<Field>, Point<Field> > >
+        get_tangents (Point<Field> const&) const;
+
+      std::pair< Point<Field>, Point<Field> >
+        get_extremal_points(Point<Field> const&) const;
+
+      size_t get_num_points() const { return size_t(records.size() + back_points.size()); }
+      size_t get_capacity() const { return capacity; }
+
+    private:
+      using arena_t = typename DynamicArray<LineSegment<Field>>::Arena;
+
+      /* Points of a stack, seen from a query point; at most eight per stack. */
+      using Cone = std::array< Point<Field>, 16 >;
+
+      struct Stack {
+        lower_hull_t lower;
+        upper_hull_t upper;
+        bool empty() const { return lower.begin() == lower.end(); }
+        size_t get_hull_size() const { return lower.get_size() + upper.get_size(); }
+        bool span(Point<Field> const&, Cone&, int&) const;
+      };
+
+      /* The segments an insertion into the front stack replaced, if it changed the chains. */
+      struct Record {
+        Point<Field> point;
+        lower_hull_t lower;
+        upper_hull_t upper;
+        bool lower_changed, upper_changed;
+      };
+
+      std::unique_ptr< arena_t > arena = std::make_unique< arena_t >();
+      size_t capacity;
+
+      Stack front, back;
+      std::vector< Record > records;           // the oldest point last
+      std::vector< Point<Field> > back_points; // the oldest point first
+
+      void refill();
+
+      template<typename Chain> bool insert(Chain&, Point<Field> const&, Chain&);
+      template<typename Chain> void undo(Chain&, Point<Field> const&, Chain&);
+
+      static bool enclosed(Point<Field> const&, Cone const&, int);
+  };
+
+  template<typename Field> SlidingWindowHull<Field>::SlidingWindowHull(size_t _capacity, uint64_t seed) : capacity(_capacity) {
+    assert( capacity >= 1 );
+    arena->seed(seed);
+  }
+
+  template<typename Field> void SlidingWindowHull<Field>::add_point(Point<Field> const& point) {
+    if( get_num_points() == capacity ) remove_oldest_point();
+    lower_hull_t lower;
+    upper_hull_t upper;
+    insert(back.lower, point, lower), lower.destroy();
+    insert(back.upper, point, upper), upper.destroy();
+    back_points.push_back(point);
+  }
+
+  template<typename Field> void SlidingWindowHull<Field>::remove_oldest_point() {
+    if( records.empty() ) refill();
+    if( records.empty() ) return;
+    auto& record = records.back();
+    if( record.lower_changed ) undo(front.lower, record.point, record.lower);
+    if( record.upper_changed ) undo(front.upper, record.point, record.upper);
+    records.pop_back();
+  }
+
+  template<typename Field> Point<Field> const& SlidingWindowHull<Field>::get_oldest_point() const {
+    return records.empty() ? back_points.front() : records.back().point;
+  }
+
+  /* Moves the back stack over to the empty front stack, the newest point first. */
+  template<typename Field> void SlidingWindowHull<Field>::refill() {
+    records.reserve(back_points.size());
+    for(auto point = back_points.rbegin(); point != back_points.rend(); point++) {
+      lower_hull_t lower;
+      upper_hull_t upper;
+      bool lower_changed = insert(front.lower, *point, lower);
+      bool upper_changed = insert(front.upper, *point, upper);
+      records.push_back(Record{*point, lower, upper, lower_changed, upper_changed});
+    }
+    back.lower.destroy(), back.upper.destroy();
+    back = Stack();
+    back_points.clear();
+  }
+
+  /* Adds a point to a chain, cutting the segments it replaces out into removed.
+   * Segments of the chain that the point sees from below, or from above for the
+   * upper chain, form a contiguous run between a prefix and a suffix that stay.
+   * Returns whether the chain changed; it does not for points on or inside it. */
+  template<typename Field> template<typename Chain>
+    bool SlidingWindowHull<Field>::insert(Chain& chain, Point<Field> const& point, Chain& removed) {
+      // positive when o, p, q turn towards the inside of the chain
+      auto turn = [](Point<Field> const& o, Point<Field> const& p, Point<Field> const& q) {
+        auto orient = orientation(o, p, q);
+        int sign = (orient > 0) - (orient < 0);
+        return std::is_same_v< Chain, upper_hull_t > ? -sign : sign;
+      };
+
+      if( chain.begin() == chain.end() ) {
+        chain = Chain(LineSegment<Field>(point, point), *arena);
+        return true;
+      }
+
+      if( not (point < chain.begin()->u) and not (chain.rbegin()->v < point) ) {
+        auto segment = chain.binary_search([&](auto const& seg) { return point < seg->v; });
+        if( segment == chain.end() or turn(segment->u, segment->v, point) >= 0 ) return false;
+      }
+
+      Chain suffix;
+      Chain::cut([&](auto const& seg) { return point < seg->v or turn(seg->u, seg->v, point) <= 0; },
+          chain, chain, removed);
+      Chain::cut([&](auto const& seg) { return not (seg->u < point) and turn(point, seg->u, seg->v) > 0; },
+          removed, removed, suffix);
+
+      bool has_removed = removed.begin() != removed.end();
+      if( chain.begin() != chain.end() )
+        Chain::join(chain, chain, Chain(LineSegment<Field>(chain.rbegin()->v, point), *arena));
+      else if( has_removed and removed.begin()->u < point )
+        Chain::join(chain, chain, Chain(LineSegment<Field>(removed.begin()->u, point), *arena));
+
+      if( suffix.begin() != suffix.end() )
+        Chain::join(chain, chain, Chain(LineSegment<Field>(point, suffix.begin()->u), *arena));
+      else if( has_removed and point < removed.rbegin()->v )
+        Chain::join(chain, chain, Chain(LineSegment<Field>(point, removed.rbegin()->v), *arena));
+
+      Chain::join(chain, chain, suffix);
+      return true;
+    }
+
+  /* Replaces the segments incident to the point by those its insertion removed. */
+  template<typename Field> template<typename Chain>
+    void SlidingWindowHull<Field>::undo(Chain& chain, Point<Field> const& point, Chain& removed) {
+      Chain incident, suffix;
+      Chain::cut([&](auto const& seg) { return not (seg->v < point); }, chain, chain, incident);
+      Chain::cut([&](auto const& seg) { return point < seg->u; }, incident, incident, suffix);
+      incident.destroy();
+      Chain::join(chain, chain, removed);
+      Chain::join(chain, chain, suffix);
+    }
+
+  /* Points of the stack generating, from the query point, the same cone as all of its
+   * points: the tangent points, and the ends of both chains with their neighbours, which
+   * complete the cone when the query point lies on the hull. The query point itself is
+   * left out. Returns false without adding anything if the hull encloses it strictly. */
+  template<typename Field> bool SlidingWindowHull<Field>::Stack::span(
+      Point<Field> const& point, Cone& cone, int& size) const {
+    if( __point_in_polygon(lower, upper, point) ) return false;
+    auto tangents = __get_tangents(lower, upper, point, get_hull_size());
+    for(auto const& generator: { tangents->first, tangents->second,
+        lower.begin()->u, lower.begin()->v, lower.rbegin()->u,
+        upper.begin()->v, upper.rbegin()->u, upper.rbegin()->v })
+      if( not (generator == point) ) cone[size++] = generator;
+    return true;
+  }
+
+  /* Whether the point is strictly inside the hull of the cone, that is whether no
+   * line through it has every point of the cone on one side. */
+  template<typename Field> bool SlidingWindowHull<Field>::enclosed(
+      Point<Field> const& point, Cone const& cone, int size) {
+    for(int i = 0; i < size; i++) {
+      bool left = true, right = true;
+      for(int j = 0; j < size and (left or right); j++) {
+        auto orient = orientation(point, cone[i], cone[j]);
+        left = left and orient >= 0, right = right and orient <= 0;
+      }
+      if( left or right ) return false;
+    }
+    return size > 0;
+  }
+
+  /* Point in polygon, tangent and farthest point queries. */
+
+  template<typename Field> bool SlidingWindowHull<Field>::point_in_polygon(Point<Field> const& point) const {
+    Cone cone;
+    int size = 0;
+    for(auto stack: { &front, &back })
+      if( not stack->empty() and not stack->span(point, cone, size) ) return true;
+    return enclosed(point, cone, size);
+  }
+
+  /* The extreme points of the cone, the farthest one where several are aligned with
+   * the query point, as in util/Tangent.hh. */
+  template<typename Field> std::optional< std::pair< Point<Field>, Point<Field> > >
+    SlidingWindowHull<Field>::get_tangents (Point<Field> const& point) const {
+      Cone cone;
+      int size = 0;
+      for(auto stack: { &front, &back })
+        if( not stack->empty() and not stack->span(point, cone, size) ) return {};
+      if( enclosed(point, cone, size) ) return {};
+      if( size == 0 ) return {{point, point}};
+
+      auto ccw_near = [&point](Point<Field> const& u, Point<Field> const& v) {
+        auto orient = orientation(point, v, u);
+        return orient > 0 or (orient == 0 and projection(u, v, u - point) < 0);
+      };
+      auto ccw_far = [&point](Point<Field> const& u, Point<Field> const& v) {
+        auto orient = orientation(point, v, u);
+        return orient > 0 or (orient == 0 and projection(u, v, u - point) > 0);
+      };
+      auto first = *std::min_element(cone.begin(), cone.begin() + size, ccw_near);
+      auto second = *std::max_element(cone.begin(), cone.begin() + size, ccw_far);
+      if( second < first ) std::swap(first, second);
+      return {{first, second}};
+    }
+
+  template<typename Field> std::pair< Point<Field>, Point<Field> >
+    SlidingWindowHull<Field>::get_extremal_points (Point<Field> const& direction) const {
+      if( front.empty() ) return __get_extremal_points(back.lower, back.upper, direction);
+      if( back.empty() ) return __get_extremal_points(front.lower, front.upper, direction);
+      auto older = __get_extremal_points(front.lower, front.upper, direction);
+      auto newer = __get_extremal_points(back.lower, back.upper, direction);
+      auto gain = projection(older.first, newer.first, direction);
+      if( gain > 0 ) return newer;
+      if( gain < 0 ) return older;
+      return {std::min(older.first, newer.first), std::max(older.second, newer.second)};
+    }
+
+}; // end namespace dpch
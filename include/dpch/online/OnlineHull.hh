@@ -2,51 +2,108 @@
 
 #include <cassert>
 #include <utility>
-#include <random>
-#include <list>
-#include <queue>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 
 #include <dpch/util/Point.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/util/Priorities.hh>
+#include <dpch/util/Instrumentation.hh>
+#include <dpch/util/ArraySummary.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/Prefilter.hh>
+#include <dpch/dynamic/HullQueries.hh>
 
 namespace dpch {
 
-  template<typename Field> class OnlineHull {
+  /* The chains keep Summary on every node, see util/ArraySummary.hh: area(), perimeter()
+   * and centroid() need ChainSummary<Field>, which the default summary leaves out. */
+  template<typename Field, typename Summary = ArraySummary< LineSegment<Field> >> class OnlineHull {
     private :
-      static std::default_random_engine engine;
-      static std::uniform_int_distribution< int32_t > rng;
-
       struct TreapNode;
 
       template<typename Predicate> static void cut(const Predicate &, Point<Field> &,
           TreapNode *, TreapNode *&, TreapNode *&);
 
       static void join(TreapNode *&, TreapNode *, TreapNode *);
+      static void update(TreapNode *);
+
+      /* Discarded subtrees wait in dump until they are taken apart, a bounded
+       * number of nodes at a time, into the free list that allocate() draws from. */
+      static constexpr int reclaim_budget = 8;
+      std::vector< TreapNode* > dump;
+      TreapNode *free_nodes = nullptr;
+      int free_count = 0;
+      Priorities priorities;
 
-      std::queue< TreapNode*, std::list<TreapNode*> > dump;
+      TreapNode * allocate(Point<Field> const&, Point<Field> const&);
       void erase(TreapNode *&);
+      void reclaim(int);
+      void trim(int);
 
       TreapNode *lower_hull = nullptr, *upper_hull = nullptr;
       Point<Field> first, last;
 
+      /* Extreme points in the eight compass directions, counterclockwise from the
+       * bottom. They are hull vertices, so a point strictly inside their octagon is
+       * interior and add_point can reject it without touching the treaps. */
+      std::array< Point<Field>, 8 > extremes;
+      uint64_t cache_probes = 0, cache_hits = 0;
+
+      HullStats stats;
+      trace_callback_t trace;
+
+      static Field extreme_key(Point<Field> const&, int);
+      void update_extremes(Point<Field> const&);
+      bool inside_extremes(Point<Field> const&) const;
+
+      TreapNode * build(std::vector< Point<Field> > const&);
+      void rebuild(std::vector< Point<Field> > const&, std::vector< Point<Field> > const&);
+
       template<typename Callback> void traverse_chain(TreapNode const*, Callback const&) const;
       template<typename Callback> void traverse_chain_in_reverse(TreapNode const*, Callback const&) const;
 
-      bool update_lower_hull (Point<Field> const&, Point<Field>&, Point<Field>&, bool);
-      bool update_upper_hull (Point<Field> const&, Point<Field>&, Point<Field>&, bool);
+      template<typename Predicate> static Point<Field> search(const Predicate &, TreapNode const *);
+      static TreapNode const * find_segment(TreapNode const *, Point<Field> const&);
+      template<typename Predicate, typename Callback> static void batch_search(Predicate const&, Callback const&,
+          TreapNode const *, std::size_t, std::size_t, TreapNode const *);
+
+      HullMeasures<Field> measures() const {
+        static_assert( std::is_same_v< Summary, ChainSummary<Field> >, "measures need OnlineHull<Field, ChainSummary<Field>>" );
+        return { lower_hull->summary, upper_hull->summary, first, last };
+      }
+
+      bool lower_tangents(Point<Field> const&, Point<Field>&, Point<Field>&) const;
+      bool upper_tangents(Point<Field> const&, Point<Field>&, Point<Field>&) const;
+      void splice(TreapNode *&, Point<Field> const&, Point<Field> const&, Point<Field> const&);
 
     public :
 
       using size_t = int32_t;
       using priority_t = int32_t;
 
-      OnlineHull(Point<Field> const&, Point<Field> const&);
+      /* Equal seeds and equal insertions give equal trees. */
+      OnlineHull(Point<Field> const&, Point<Field> const&, uint64_t seed = Priorities::default_seed);
+      OnlineHull(std::span< Point<Field> const >, uint64_t seed = Priorities::default_seed);
       ~OnlineHull();
 
       bool add_point(Point<Field> const&);
+      bool add_points(std::span< Point<Field> const >);
+
+      bool point_in_polygon(Point<Field> const&) const;
+
+      std::pair< bool, std::pair< Point<Field>, Point<Field> > > get_tangents (Point<Field> const&) const;
 
-      std::pair< bool, std::pair< Point<Field>, Point<Field> > > get_tangents (Point<Field> const&);
+      std::pair< Point<Field>, Point<Field> > get_extremal_points(Point<Field> const&) const;
 
-      std::pair< Point<Field>, Point<Field> > get_extremal_points(Point<Field> const&);
+      /* get_extremal_points for every direction; enough of them are sorted by angle and
+       * searched for together, see __get_extremal_points_batch. */
+      std::vector< std::pair< Point<Field>, Point<Field> > >
+        get_extremal_points_batch(std::span< Point<Field> const >) const;
 
       template<typename Callback> void traverse_lower_hull(Callback const&) const;
       template<typename Callback> void traverse_upper_hull(Callback const&) const;
@@ -55,48 +112,114 @@ namespace dpch {
       size_t get_lower_hull_size() const;
       size_t get_upper_hull_size() const;
       size_t get_hull_size() const;
+
+      /* Measures of the hull in constant time, from the summaries the chains keep
+       * through every insertion; see HullMeasures. Only for Summary = ChainSummary<Field>. */
+      double area() const { return measures().area(); }
+      double perimeter() const { return measures().perimeter(); }
+      Point<double> centroid() const { return measures().centroid(); }
+
+      uint64_t get_cache_probes() const { return cache_probes; }
+      uint64_t get_cache_hits() const { return cache_hits; }
+
+      /* Work done by updates, when built with DPCH_INSTRUMENT; see util/Instrumentation.hh.
+       * Nodes are freed when taken apart for reuse, and the height is that of the chains. */
+      HullStats const& get_stats() const { return stats; }
+      void reset_stats() { stats = HullStats(); }
+      void set_trace(trace_callback_t _trace) { trace = std::move(_trace); }
   };
 
-  template<typename Field>
-    struct OnlineHull<Field>::TreapNode {
-      OnlineHull<Field>::priority_t priority;
-      OnlineHull<Field>::size_t size;
+  template<typename Field, typename Summary>
+    struct OnlineHull<Field, Summary>::TreapNode {
+      OnlineHull<Field, Summary>::priority_t priority;
+      OnlineHull<Field, Summary>::size_t size;
       TreapNode *left, *right;
       Point< Field > u, v;
-      TreapNode(Point<Field> const &u, Point<Field> const &v):
-        priority(rng(engine)), size(1), left(nullptr), right(nullptr), u(u), v(v) { }
+      [[no_unique_address]] Summary summary;
+      TreapNode(Point<Field> const &u, Point<Field> const &v, OnlineHull<Field, Summary>::priority_t priority):
+        priority(priority), size(1), left(nullptr), right(nullptr), u(u), v(v), summary(LineSegment<Field>(u, v)) { }
     };
 
-  template<typename Field> std::default_random_engine OnlineHull<Field>::engine;
 
-  template<typename Field> std::uniform_int_distribution< int32_t > OnlineHull<Field>::rng;
-
-  template<typename Field> OnlineHull<Field>::OnlineHull(Point<Field> const&p, Point<Field> const&q) {
+  template<typename Field, typename Summary> OnlineHull<Field, Summary>::OnlineHull(Point<Field> const&p, Point<Field> const&q, uint64_t seed)
+    : priorities(seed) {
     assert( not (p == q) );
     if( p < q ) first = p, last = q;
     else first = q, last = p;
-    lower_hull = new TreapNode(first, last);
-    upper_hull = new TreapNode(first, last);
+    lower_hull = allocate(first, last);
+    upper_hull = allocate(first, last);
+    extremes.fill(first), update_extremes(last);
+  }
+
+  /* Bulk construction; the points must not all coincide. */
+  template<typename Field, typename Summary> OnlineHull<Field, Summary>::OnlineHull(std::span< Point<Field> const > points, uint64_t seed)
+    : priorities(seed) {
+    std::vector< Point<Field> > polygon(points.begin(), points.end());
+    std::sort(polygon.begin(), polygon.end());
+    polygon.erase(std::unique(polygon.begin(), polygon.end()), polygon.end());
+    assert( polygon.size() >= 2 );
+    auto [lower_chain, upper_chain] = convex_hull(polygon, true);
+    rebuild(lower_chain, upper_chain);
   }
 
-  template<typename Field> OnlineHull<Field>::~OnlineHull() {
-    dump.push(lower_hull), dump.push(upper_hull);
+  template<typename Field, typename Summary> OnlineHull<Field, Summary>::~OnlineHull() {
+    dump.push_back(lower_hull), dump.push_back(upper_hull);
     while( not dump.empty() ) {
-      auto node = dump.front();
-      if( node->left != nullptr ) dump.push(node->left);
-      if( node->right != nullptr ) dump.push(node->right);
-      dump.pop(), delete node;
+      auto node = dump.back(); dump.pop_back();
+      if( node->left != nullptr ) dump.push_back(node->left);
+      if( node->right != nullptr ) dump.push_back(node->right);
+      delete node;
+    }
+    while( free_nodes != nullptr ) {
+      auto node = free_nodes;
+      free_nodes = node->right;
+      delete node;
     }
   }
 
-  template<typename Field> void OnlineHull<Field>::erase(TreapNode *&node) {
-    if( node != nullptr ) dump.push(node);
+  template<typename Field, typename Summary> typename OnlineHull<Field, Summary>::TreapNode *
+    OnlineHull<Field, Summary>::allocate(Point<Field> const&u, Point<Field> const&v) {
+      DPCH_COUNT(allocated);
+      if( free_nodes == nullptr ) reclaim(1);
+      if( free_nodes == nullptr ) return new TreapNode(u, v, priorities());
+      auto node = free_nodes;
+      free_nodes = node->right, free_count--;
+      *node = TreapNode(u, v, priorities());
+      return node;
+    }
+
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::erase(TreapNode *&node) {
+    if( node != nullptr ) dump.push_back(node);
     node = nullptr;
   }
 
-  template<typename Field> template<typename Predicate>
-    void OnlineHull<Field>::cut(const Predicate &predicate, Point<Field> &split,
+  /* Takes apart up to budget discarded nodes into the free list. */
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::reclaim(int budget) {
+    while( budget-- > 0 and not dump.empty() ) {
+      auto node = dump.back(); dump.pop_back();
+      DPCH_COUNT(freed);
+      if( node->left != nullptr ) dump.push_back(node->left);
+      if( node->right != nullptr ) dump.push_back(node->right);
+      node->left = nullptr, node->right = free_nodes;
+      free_nodes = node, free_count++;
+    }
+  }
+
+  /* Returns up to budget spare nodes beyond the live hull size to the allocator,
+   * so memory follows the hull as it shrinks. */
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::trim(int budget) {
+    while( budget-- > 0 and free_count > get_hull_size() ) {
+      auto node = free_nodes;
+      free_nodes = node->right, free_count--;
+      delete node;
+    }
+  }
+
+  template<typename Field, typename Summary> template<typename Predicate>
+    void OnlineHull<Field, Summary>::cut(const Predicate &predicate, Point<Field> &split,
         TreapNode *treap_root, TreapNode *&left_root, TreapNode *&right_root) {
+      DPCH_RECURSION(cuts, cut_depth);
+      DPCH_LEVEL(height);
       if( treap_root == nullptr ) {
         left_root = right_root = nullptr;
         return;
@@ -110,13 +233,12 @@ namespace dpch {
         cut(predicate, split, treap_root->right, treap_root->right, right_root);
         left_root = treap_root;
       }
-      treap_root->size = 1
-        + (treap_root->left  == nullptr ? 0 : treap_root->left ->size)
-        + (treap_root->right == nullptr ? 0 : treap_root->right->size);
+      update(treap_root);
     }
 
-  template<typename Field> void OnlineHull<Field>::join(TreapNode *&root,
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::join(TreapNode *&root,
       TreapNode *left_root, TreapNode *right_root) {
+    DPCH_RECURSION(joins, join_depth);
     if( left_root == nullptr or right_root == nullptr ) {
       root = ( left_root == nullptr ? right_root : left_root );
       return;
@@ -128,95 +250,224 @@ namespace dpch {
       join(left_root->right, left_root->right, right_root);
       root = left_root;
     }
-    root->size = 1
-      + (root->left  == nullptr ? 0 : root->left ->size)
-      + (root->right == nullptr ? 0 : root->right->size);
+    update(root);
+  }
+
+  /* Size and summary of a node from those of its children. */
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::update(TreapNode *node) {
+    node->size = 1
+      + (node->left  == nullptr ? 0 : node->left ->size)
+      + (node->right == nullptr ? 0 : node->right->size);
+    if constexpr ( std::is_empty_v<Summary> ) return;
+    Summary summary;
+    if( node->left != nullptr ) summary = node->left->summary;
+    summary.add(Summary(LineSegment<Field>(node->u, node->v)));
+    if( node->right != nullptr ) summary.add(node->right->summary);
+    node->summary = summary;
+  }
+
+  /* Cartesian tree over the segments of a chain, in linear time. */
+  template<typename Field, typename Summary> typename OnlineHull<Field, Summary>::TreapNode *
+    OnlineHull<Field, Summary>::build(std::vector< Point<Field> > const& chain) {
+      std::vector< TreapNode* > spine;
+      for(std::size_t i = 1; i < chain.size(); i++) {
+        TreapNode *node = allocate(chain[i-1], chain[i]), *last = nullptr;
+        while( not spine.empty() and spine.back()->priority < node->priority ) {
+          last = spine.back(), spine.pop_back();
+          update(last);
+        }
+        node->left = last;
+        if( not spine.empty() ) spine.back()->right = node;
+        spine.push_back(node);
+      }
+      while( spine.size() > 1 ) {
+        auto last = spine.back(); spine.pop_back();
+        update(last);
+      }
+      auto root = spine.front();
+      update(root);
+      return root;
+    }
+
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::rebuild(
+      std::vector< Point<Field> > const& lower_chain, std::vector< Point<Field> > const& upper_chain) {
+    erase(lower_hull), erase(upper_hull);
+    first = lower_chain.front(), last = lower_chain.back();
+    lower_hull = build(lower_chain);
+    upper_hull = build(upper_chain);
+    extremes.fill(first);
+    for(auto const chain: {&lower_chain, &upper_chain})
+      for(auto const& point: *chain) update_extremes(point);
+  }
+
+  template<typename Field, typename Summary> Field OnlineHull<Field, Summary>::extreme_key(Point<Field> const& point, int direction) {
+    switch( direction ) {
+      case 0: return -point.y;
+      case 1: return point.x - point.y;
+      case 2: return point.x;
+      case 3: return point.x + point.y;
+      case 4: return point.y;
+      case 5: return point.y - point.x;
+      case 6: return -point.x;
+      default: return -point.x - point.y;
+    }
   }
 
-  template<typename Field> template<typename Callback>
-    void OnlineHull<Field>::traverse_lower_hull(Callback const&callback) const {
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::update_extremes(Point<Field> const& point) {
+    for(int direction = 0; direction < 8; direction++)
+      if( extreme_key(extremes[direction], direction) < extreme_key(point, direction) )
+        extremes[direction] = point;
+  }
+
+  /* Strictly left of every proper edge; with fewer than three edges nothing is inside. */
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::inside_extremes(Point<Field> const& point) const {
+    int edges = 0;
+    for(int direction = 0; direction < 8; direction++) {
+      auto const& u = extremes[direction];
+      auto const& v = extremes[(direction + 1) % 8];
+      if( u == v ) continue;
+      if( orientation(u, v, point) <= 0 ) return false;
+      edges++;
+    }
+    return edges >= 3;
+  }
+
+  template<typename Field, typename Summary> template<typename Callback>
+    void OnlineHull<Field, Summary>::traverse_lower_hull(Callback const&callback) const {
       traverse_chain(lower_hull, callback);
       callback(last);
     }
 
-  template<typename Field> template<typename Callback>
-    void OnlineHull<Field>::traverse_upper_hull(Callback const&callback) const {
+  template<typename Field, typename Summary> template<typename Callback>
+    void OnlineHull<Field, Summary>::traverse_upper_hull(Callback const&callback) const {
       traverse_chain(upper_hull, callback);
       callback(last);
     }
 
-  template<typename Field> template<typename Callback>
-    void OnlineHull<Field>::traverse_hull(Callback const&callback) const {
+  template<typename Field, typename Summary> template<typename Callback>
+    void OnlineHull<Field, Summary>::traverse_hull(Callback const&callback) const {
       traverse_chain(lower_hull, callback);
       traverse_chain_in_reverse(upper_hull, callback);
     }
 
-  template<typename Field> 
-    typename OnlineHull<Field>::size_t OnlineHull<Field>::get_lower_hull_size() const {
+  template<typename Field, typename Summary> 
+    typename OnlineHull<Field, Summary>::size_t OnlineHull<Field, Summary>::get_lower_hull_size() const {
       return 1 + lower_hull->size;
     }
 
-  template<typename Field>
-    typename OnlineHull<Field>::size_t OnlineHull<Field>::get_upper_hull_size() const {
+  template<typename Field, typename Summary>
+    typename OnlineHull<Field, Summary>::size_t OnlineHull<Field, Summary>::get_upper_hull_size() const {
       return 1 + upper_hull->size;
     }
 
-  template<typename Field>
-    typename OnlineHull<Field>::size_t
-    OnlineHull<Field>::get_hull_size() const {
+  template<typename Field, typename Summary>
+    typename OnlineHull<Field, Summary>::size_t
+    OnlineHull<Field, Summary>::get_hull_size() const {
       return lower_hull->size + upper_hull->size;
     }
 
-  template<typename Field> template<typename Callback>
-    void OnlineHull<Field>::traverse_chain(TreapNode const*node, Callback const&callback) const {
+  template<typename Field, typename Summary> template<typename Callback>
+    void OnlineHull<Field, Summary>::traverse_chain(TreapNode const*node, Callback const&callback) const {
       if( node == nullptr ) return;
       traverse_chain(node->left, callback);
       callback(node->u);
       traverse_chain(node->right, callback);
     }
 
-  template<typename Field>
+  template<typename Field, typename Summary>
     template<typename Callback>
-    void OnlineHull<Field>::traverse_chain_in_reverse(TreapNode const*node, Callback const&callback) const {
+    void OnlineHull<Field, Summary>::traverse_chain_in_reverse(TreapNode const*node, Callback const&callback) const {
       if( node == nullptr ) return;
-      traverse_chain(node->right, callback);
+      traverse_chain_in_reverse(node->right, callback);
       callback(node->v);
-      traverse_chain(node->left, callback);
+      traverse_chain_in_reverse(node->left, callback);
     }
 
-  template<typename Field> bool OnlineHull<Field>::add_point(Point<Field> const& point) {
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::add_point(Point<Field> const& point) {
+    DPCH_OPERATION(stats, trace, "add_point");
+    cache_probes++;
+    if( inside_extremes(point) ) return cache_hits++, false;
+    update_extremes(point);
     Point<Field> left_tangent, right_tangent;
-    bool lower_hull_updated = update_lower_hull(point, left_tangent, right_tangent, true);
-    bool upper_hull_updated = update_upper_hull(point, left_tangent, right_tangent, true);
+    bool lower_hull_updated = lower_tangents(point, left_tangent, right_tangent);
+    if( lower_hull_updated ) splice(lower_hull, point, left_tangent, right_tangent);
+    bool upper_hull_updated = upper_tangents(point, left_tangent, right_tangent);
+    if( upper_hull_updated ) splice(upper_hull, point, left_tangent, right_tangent);
     if( point < first ) first = point;
     if( last < point  ) last  = point;
+    reclaim(reclaim_budget), trim(reclaim_budget);
     return lower_hull_updated or upper_hull_updated;
   }
 
-  template<typename Field> std::pair< bool, std::pair< Point<Field>, Point<Field> > >
-    OnlineHull<Field>::get_tangents(Point<Field> const& point) {
+  /* Prefilters the batch against its own extreme points and hulls it on its own,
+   * then either inserts the few surviving batch hull vertices one at a time, or
+   * when there are too many of those, merges both pairs of sorted chains and
+   * rebuilds the treaps in linear time. */
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::add_points(std::span< Point<Field> const > points) {
+    DPCH_OPERATION(stats, trace, "add_points");
+    if( points.empty() ) return false;
+    std::vector< Point<Field> > batch(points.begin(), points.end());
+    if( batch.size() >= prefilter_threshold ) batch.resize(prefilter(std::span< Point<Field> >(batch)));
+    std::sort(batch.begin(), batch.end());
+    batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+    auto [batch_lower, batch_upper] = convex_hull(batch, true);
+
+    std::size_t candidates = batch_lower.size() + batch_upper.size(), hull_size = get_hull_size();
+    std::size_t depth = 1;
+    while( (std::size_t(1) << depth) < hull_size ) depth++;
+
+    if( candidates * depth < hull_size + candidates ) {
+      bool updated = false;
+      for(auto const chain: {&batch_lower, &batch_upper})
+        for(auto const& point: *chain) updated |= add_point(point);
+      return updated;
+    }
+
+    std::vector< Point<Field> > hull_lower, hull_upper, polygon;
+    traverse_lower_hull([&](Point<Field> const&point) { hull_lower.push_back(point); });
+    traverse_upper_hull([&](Point<Field> const&point) { hull_upper.push_back(point); });
+    std::vector< Point<Field> > lower, upper;
+    std::merge(hull_lower.begin(), hull_lower.end(), batch_lower.begin(), batch_lower.end(), std::back_inserter(lower));
+    std::merge(hull_upper.begin(), hull_upper.end(), batch_upper.begin(), batch_upper.end(), std::back_inserter(upper));
+    std::merge(lower.begin(), lower.end(), upper.begin(), upper.end(), std::back_inserter(polygon));
+    polygon.erase(std::unique(polygon.begin(), polygon.end()), polygon.end());
+
+    auto [lower_chain, upper_chain] = convex_hull(polygon, true);
+    bool updated = not (lower_chain == hull_lower and upper_chain == hull_upper);
+    if( updated ) rebuild(lower_chain, upper_chain);
+    reclaim(reclaim_budget), trim(reclaim_budget);
+    return updated;
+  }
+
+  /* Strictly inside the hull. */
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::point_in_polygon(Point<Field> const& point) const {
+    if( point < first or last < point ) return false;
+    auto lower_segment = find_segment(lower_hull, point), upper_segment = find_segment(upper_hull, point);
+    return orientation(lower_segment->u, lower_segment->v, point) > 0 and
+      orientation(upper_segment->u, upper_segment->v, point) < 0;
+  }
+
+  template<typename Field, typename Summary> std::pair< bool, std::pair< Point<Field>, Point<Field> > >
+    OnlineHull<Field, Summary>::get_tangents(Point<Field> const& point) const {
       bool outside = false;
       std::pair< Point<Field>, Point<Field> > tangents;
       if( point < first or last < point ) {
-        update_lower_hull(point, tangents.first, tangents.second, false);
-        update_upper_hull(point, tangents.second, tangents.first, false);
+        lower_tangents(point, tangents.first, tangents.second);
+        upper_tangents(point, tangents.second, tangents.first);
         if( tangents.second < tangents.first ) std::swap(tangents.first, tangents.second);
         outside = true;
       } else {
-        bool lower_hull_updated = update_lower_hull(point, tangents.first, tangents.second, false);
-        bool upper_hull_updated = false;
-        if( not lower_hull_updated )
-          upper_hull_updated = update_upper_hull(point, tangents.first, tangents.second, false);
-        outside = ( lower_hull_updated or upper_hull_updated );
+        outside = lower_tangents(point, tangents.first, tangents.second) or
+          upper_tangents(point, tangents.first, tangents.second);
       }
       return std::make_pair(outside, tangents);
     }
 
-  template<typename Field> std::pair< Point<Field>, Point<Field> >
-    OnlineHull<Field>::get_extremal_points(Point<Field> const&direction) {
+  template<typename Field, typename Summary> std::pair< Point<Field>, Point<Field> >
+    OnlineHull<Field, Summary>::get_extremal_points(Point<Field> const&direction) const {
       std::pair< Point<Field>, Point<Field> > points{first, last};
       auto dip = [&direction](TreapNode const&node)
-      { return ( (node.v - node.u) ^ direction ) <= 0; };
+      { return projection(node.u, node.v, direction) <= 0; };
       TreapNode const * it = 
         ( direction.y > 0 or (direction.y == 0 and direction.x < 0) ? upper_hull : lower_hull );
       while( it != nullptr ) {
@@ -227,175 +478,151 @@ namespace dpch {
           it = it->right;
         }
       }
-      if( (points.second ^ direction) < (points.first ^ direction) ) points.second = points.first;
-      if( (points.first ^ direction) < (points.second ^ direction) ) points.first = points.second;
+      if( projection(points.first, points.second, direction) < 0 ) points.second = points.first;
+      if( projection(points.second, points.first, direction) < 0 ) points.first = points.second;
       return points;
     }
 
-  template<typename Field> bool OnlineHull<Field>::update_lower_hull(Point<Field> const& point,
-      Point<Field> &left_tangent, Point<Field> &right_tangent, bool update) {
-
-    auto left_cond = [this, &point](TreapNode const&node) -> bool
-    { return (point - node.v) * (node.v - node.u) >= 0; };
-    auto right_cond = [this, &point](TreapNode const&node) -> bool
-    { return (node.u - point) * (node.v - node.u) > 0; };
-
-    TreapNode *prefix = nullptr, *suffix = nullptr;
-
-    if( last < point ) {
-      cut(left_cond, left_tangent, lower_hull, prefix, suffix);
-      if( update ) {
-        erase(suffix);
-        join(lower_hull, prefix, new TreapNode(left_tangent, point));
-      } else {
-        join(lower_hull, prefix, suffix);
+  /* Sorts the directions by angle and descends each chain once for all of its directions,
+   * as __get_extremal_points_batch does for the dynamic hulls. */
+  template<typename Field, typename Summary> std::vector< std::pair< Point<Field>, Point<Field> > >
+    OnlineHull<Field, Summary>::get_extremal_points_batch(std::span< Point<Field> const > directions) const {
+      std::vector< std::pair< Point<Field>, Point<Field> > > extremes(directions.size());
+      if( not __sweep_directions(directions.size(), std::size_t(get_hull_size())) ) {
+        for(std::size_t i = 0; i < directions.size(); i++) extremes[i] = get_extremal_points(directions[i]);
+        return extremes;
       }
-      return true;
+      std::vector< std::size_t > upper, lower;
+      for(auto i: __sort_directions(directions, upper, lower)) extremes[i] = get_extremal_points(directions[i]);
+
+      auto search = [&](TreapNode const *chain, std::vector< std::size_t > const& order) {
+        batch_search(
+            [&](TreapNode const& node, std::size_t k) { return projection(node.u, node.v, directions[order[k]]) <= 0; },
+            [&](std::size_t k, TreapNode const *node) {
+              LineSegment<Field> segment{first, last};
+              if( node != nullptr ) segment = {node->u, node->v};
+              extremes[order[k]] = __extremal_points(segment, directions[order[k]]);
+            }, chain, 0, order.size(), nullptr);
+      };
+      search(upper_hull, upper);
+      search(lower_hull, lower);
+      return extremes;
     }
 
-    if( point < first ) {
-      cut(right_cond, right_tangent, lower_hull, prefix, suffix);
-
-      if( update ) {
-        erase(prefix);
-        join(lower_hull, new TreapNode(point, right_tangent), suffix);
-      } else {
-        join(lower_hull, prefix, suffix);
+  /* Descends the chain for queries first to last - 1 at once, with predicate(node, query)
+   * monotone along the chain for each query and the node it finds moving right from one
+   * query to the next; callback(query, node) gets each result, nullptr if none. */
+  template<typename Field, typename Summary> template<typename Predicate, typename Callback>
+    void OnlineHull<Field, Summary>::batch_search(Predicate const& predicate, Callback const& callback,
+        TreapNode const *node, std::size_t first, std::size_t last, TreapNode const *found) {
+      if( first == last ) return;
+      if( node == nullptr ) {
+        for(auto query = first; query < last; query++) callback(query, found);
+        return;
+      }
+      auto lo = first, hi = last;
+      while( lo < hi ) {
+        auto middle = lo + (hi - lo) / 2;
+        if( predicate(*node, middle) ) lo = middle + 1;
+        else hi = middle;
       }
-      return true;
+      batch_search(predicate, callback, node->left, first, lo, node);
+      batch_search(predicate, callback, node->right, lo, last, found);
     }
 
-    TreapNode *segment = nullptr;
-    Point<Field> left_split, right_split;
-
-    cut([this, &point](TreapNode const&node){return point < node.u;}, right_split, lower_hull, prefix, suffix);
-    cut([this, &point](TreapNode const&node){return !(node.v < point);}, left_split, prefix, prefix, segment);
-
-    Field cross_product = ((segment->v-segment->u) * (point-segment->u));
-    bool interior_point = (cross_product >= 0);
-
-    if( interior_point ) {
-      join(prefix, prefix, segment);
-      join(lower_hull, prefix, suffix);
-      return false;
+  /* Reads the split point cut would leave between the nodes failing and those
+   * satisfying a predicate that is monotone along the chain. */
+  template<typename Field, typename Summary> template<typename Predicate>
+    Point<Field> OnlineHull<Field, Summary>::search(const Predicate &predicate, TreapNode const *node) {
+      Point<Field> split;
+      while( node != nullptr ) {
+        if( predicate(*node) ) split = node->u, node = node->left;
+        else split = node->v, node = node->right;
+      }
+      return split;
     }
 
-    TreapNode *inside = nullptr, *outside = nullptr;
-
-    if( update ) erase(segment);
-
-    cut(left_cond, left_split, prefix, outside, inside);
-    left_tangent = left_split;
-
-    if( update ) {
-      erase(inside);
-      join(prefix, outside, new TreapNode(left_split, point));
-    } else {
-      join(prefix, outside, inside);
+  /* The last segment starting at or before point; point must lie within [first, last]. */
+  template<typename Field, typename Summary> typename OnlineHull<Field, Summary>::TreapNode const *
+    OnlineHull<Field, Summary>::find_segment(TreapNode const *node, Point<Field> const& point) {
+      TreapNode const *segment = nullptr;
+      while( node != nullptr ) {
+        if( point < node->u ) node = node->left;
+        else segment = node, node = node->right;
+      }
+      return segment;
     }
 
-    cut(right_cond, right_split, suffix, inside, outside);
-    right_tangent = right_split;
+  /* Whether point lies strictly below the lower hull, and if so the points where its
+   * tangents touch the chain; points beyond either end only get the tangent facing
+   * the chain. Segments on the far side of point count as satisfying the left
+   * tangent predicate and failing the right one, so a single descent finds each. */
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::lower_tangents(Point<Field> const& point,
+      Point<Field> &left_tangent, Point<Field> &right_tangent) const {
 
-    if( update ) {
-      erase(inside);
-      join(suffix, new TreapNode(point, right_split), outside);
-    } else {
-      join(suffix, inside, outside);
-    }
+    auto left_cond = [&point](TreapNode const&node) -> bool
+    { return orientation(node.u, node.v, point) <= 0; };
+    auto right_cond = [&point](TreapNode const&node) -> bool
+    { return orientation(node.u, node.v, point) > 0; };
 
-    if( update ) {
-      join(lower_hull, prefix, suffix);
-    } else {
-      join(prefix, prefix, segment);
-      join(lower_hull, prefix, suffix);
-    }
+    if( last < point ) return left_tangent = search(left_cond, lower_hull), true;
+    if( point < first ) return right_tangent = search(right_cond, lower_hull), true;
+
+    auto segment = find_segment(lower_hull, point);
+    if( orientation(segment->u, segment->v, point) >= 0 ) return false;
 
+    left_tangent = search([&](TreapNode const&node) { return not (node.v < point) or left_cond(node); }, lower_hull);
+    right_tangent = search([&](TreapNode const&node) { return point < node.u and right_cond(node); }, lower_hull);
     return true;
   }
 
-  template<typename Field> bool OnlineHull<Field>::update_upper_hull(Point<Field> const& point,
-      Point<Field> &left_tangent, Point<Field> &right_tangent, bool update) {
-
-    auto left_cond = [this, &point](TreapNode const&node) -> bool
-    { return (node.v - node.u) * (point - node.v) >= 0; };
-
-    auto right_cond = [this, &point](TreapNode const&node) -> bool
-    { return (node.v - node.u) * (node.u - point) > 0; };
-
-    TreapNode *prefix = nullptr, *suffix = nullptr;
-
-    if( last < point ) {
-      cut(left_cond, left_tangent, upper_hull, prefix, suffix);
-
-      if( update ) {
-        erase(suffix);
-        join(upper_hull, prefix, new TreapNode(left_tangent, point));
-      } else {
-        join(upper_hull, prefix, suffix);
-      }
-      return true;
-    }
-
-    if( point < first ) {
-      cut(right_cond, right_tangent, upper_hull, prefix, suffix);
+  /* Mirror image of lower_tangents for points strictly above the upper hull. */
+  template<typename Field, typename Summary> bool OnlineHull<Field, Summary>::upper_tangents(Point<Field> const& point,
+      Point<Field> &left_tangent, Point<Field> &right_tangent) const {
 
-      if( update ) {
-        erase(prefix);
-        join(upper_hull, new TreapNode(point, right_tangent), suffix);
-      } else {
-        join(upper_hull, prefix, suffix);
-      }
-      return true;
-    }
-
-    TreapNode *segment = nullptr;
-    Point<Field> left_split, right_split;
+    auto left_cond = [&point](TreapNode const&node) -> bool
+    { return orientation(node.u, node.v, point) >= 0; };
+    auto right_cond = [&point](TreapNode const&node) -> bool
+    { return orientation(node.u, node.v, point) < 0; };
 
-    cut([this, &point](TreapNode const&node) {return point < node.u;}, right_split, upper_hull, prefix, suffix);
-    cut([this, &point](TreapNode const&node) {return !(node.v < point);}, left_split, prefix, prefix, segment);
-
-    Field cross_product = ((segment->v-segment->u) * (point-segment->u));
-    bool interior_point = (cross_product <= 0);
-
-    if( interior_point ) {
-      join(prefix, prefix, segment);
-      join(upper_hull, prefix, suffix);
-      return false;
-    }
+    if( last < point ) return left_tangent = search(left_cond, upper_hull), true;
+    if( point < first ) return right_tangent = search(right_cond, upper_hull), true;
 
-    TreapNode *inside = nullptr, *outside = nullptr;
+    auto segment = find_segment(upper_hull, point);
+    if( orientation(segment->u, segment->v, point) <= 0 ) return false;
 
-    if( update ) erase(segment);
+    left_tangent = search([&](TreapNode const&node) { return not (node.v < point) or left_cond(node); }, upper_hull);
+    right_tangent = search([&](TreapNode const&node) { return point < node.u and right_cond(node); }, upper_hull);
+    return true;
+  }
 
-    cut(left_cond, left_split, prefix, outside, inside);
-    left_tangent = left_split;
+  /* Replaces the segments between the tangents with the two through point, or at
+   * either end of the chain with the one segment from the tangent to point. */
+  template<typename Field, typename Summary> void OnlineHull<Field, Summary>::splice(TreapNode *&hull, Point<Field> const& point,
+      Point<Field> const& left_tangent, Point<Field> const& right_tangent) {
+    TreapNode *prefix = nullptr, *inside = nullptr, *suffix = nullptr;
+    Point<Field> split;
 
-    if( update ) {
+    if( last < point ) {
+      cut([&](TreapNode const&node) { return left_tangent < node.v; }, split, hull, prefix, inside);
       erase(inside);
-      join(prefix, outside, new TreapNode(left_split, point));
-    } else {
-      join(prefix, outside, inside);
+      join(hull, prefix, allocate(left_tangent, point));
+      return;
     }
 
-    cut(right_cond, right_split, suffix, inside, outside);
-    right_tangent = right_split;
-
-    if( update ) {
+    if( point < first ) {
+      cut([&](TreapNode const&node) { return not (node.u < right_tangent); }, split, hull, inside, suffix);
       erase(inside);
-      join(suffix, new TreapNode(point, right_split), outside);
-    } else {
-      join(suffix, inside, outside);
-    }
-
-    if( update ) {
-      join(upper_hull, prefix, suffix);
-    } else {
-      join(prefix, prefix, segment);
-      join(upper_hull, prefix, suffix);
+      join(hull, allocate(point, right_tangent), suffix);
+      return;
     }
 
-    return true;
+    cut([&](TreapNode const&node) { return left_tangent < node.v; }, split, hull, prefix, suffix);
+    cut([&](TreapNode const&node) { return not (node.u < right_tangent); }, split, suffix, inside, suffix);
+    erase(inside);
+    join(prefix, prefix, allocate(left_tangent, point));
+    join(suffix, allocate(point, right_tangent), suffix);
+    join(hull, prefix, suffix);
   }
 
 }; // end namespace dpch
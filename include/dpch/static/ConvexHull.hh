@@ -2,25 +2,35 @@
 
 #include <algorithm>
 #include <vector>
+#include <span>
 
 using std::vector;
 using std::pair;
 
 #include <dpch/util/Point.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/static/Prefilter.hh>
 
 namespace dpch {
   template<typename T> using Chain = vector< Point<T> >;
 
-  /* Andrew's monotone chain algorithm. Assumes that input points are unique. */
+  /* Andrew's monotone chain algorithm. Assumes that input points are unique.
+   * Sorts the points in place rather than copying them, after moving those that
+   * survive the interior prefilter to the front. */
   template<typename T> pair< Chain<T>, Chain<T> > convex_hull
-    (vector< Point <T> > polygon, bool sorted = true, bool collinear = false) {
+    (std::span< Point <T> > polygon, bool sorted = true, bool collinear = false) {
+
+      if( polygon.size() >= prefilter_threshold ) {
+        polygon = polygon.first(prefilter(polygon)); // keeps sorted points sorted
+      }
 
       if( not sorted ) {
         sort(polygon.begin(), polygon.end()); // sort lexicographically 
       }
 
       if( polygon.size() <= 1 ) {
-        return pair<Chain<T>, Chain<T>>{polygon, polygon};
+        Chain<T> chain(polygon.begin(), polygon.end());
+        return pair<Chain<T>, Chain<T>>{chain, chain};
       }
 
       Chain<T>  lower_chain, upper_chain;
@@ -30,10 +40,8 @@ namespace dpch {
 
       for(auto &point: polygon) {
         while( lower_chain.size() >= 2 ) {
-          auto first_segment = lower_chain[lower_chain.size()-1] - lower_chain[lower_chain.size()-2];
-          auto second_segment = point - lower_chain[lower_chain.size()-1];
-          if( (not collinear and first_segment * second_segment <= 0)
-              or (collinear and first_segment * second_segment < 0))
+          auto turn = orientation(lower_chain[lower_chain.size()-2], lower_chain[lower_chain.size()-1], point);
+          if( (not collinear and turn <= 0) or (collinear and turn < 0) )
             lower_chain.pop_back();
           else break;
         }
@@ -41,10 +49,8 @@ namespace dpch {
         lower_chain.emplace_back(point);
 
         while( upper_chain.size() >= 2 ) {
-          auto first_segment = upper_chain[upper_chain.size()-1] - upper_chain[upper_chain.size()-2];
-          auto second_segment = point - upper_chain[upper_chain.size()-1];
-          if( (not collinear and first_segment * second_segment >= 0)
-              or(collinear and first_segment * second_segment > 0) )
+          auto turn = orientation(upper_chain[upper_chain.size()-2], upper_chain[upper_chain.size()-1], point);
+          if( (not collinear and turn >= 0) or (collinear and turn > 0) )
             upper_chain.pop_back();
           else break;
         }
@@ -55,4 +61,9 @@ namespace dpch {
       return pair<Chain<T>, Chain<T>>{lower_chain, upper_chain};
     }
 
+  template<typename T> pair< Chain<T>, Chain<T> > convex_hull
+    (vector< Point <T> > polygon, bool sorted = true, bool collinear = false) {
+      return convex_hull(std::span< Point<T> >(polygon), sorted, collinear);
+    }
+
 }; // end namespace dpch
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/Prefilter.hh>
+
+namespace dpch {
+
+  /* Gift wrapping over the chains of presorted groups, from the lexicographically
+   * smallest point towards the largest. The lower chain turns clockwise-most at every
+   * step and the upper chain counterclockwise-most; collinear candidates resolve to
+   * the nearest point when collinear points are kept and to the farthest otherwise.
+   * Gives up once the chain would exceed limit edges. */
+  template<typename T> bool __wrap_chain(std::vector< Chain<T> > const& groups, bool lower,
+      bool collinear, std::size_t limit, Chain<T>& chain) {
+    auto beyond = [lower, collinear] (Point<T> const& p, Point<T> const& a, Point<T> const& b) {
+      auto turn = orientation(p, a, b);
+      if( lower ) turn = -turn;
+      return turn > 0 or (turn == 0 and (collinear ? b < a : a < b));
+    };
+
+    chain.assign(1, groups.front().front());
+    for(auto const& group: groups) chain.front() = std::min(chain.front(), group.front());
+
+    while( chain.size() <= limit ) {
+      auto const p = chain.back();
+      Point<T> const* best = nullptr;
+      for(auto const& group: groups) {
+        /* Past p, the group chain is unimodal with respect to the wrapping order. */
+        std::size_t lo = std::upper_bound(group.begin(), group.end(), p) - group.begin(), hi = group.size() - 1;
+        if( lo == group.size() ) continue;
+        while( lo < hi ) {
+          auto mid = (lo + hi) / 2;
+          if( beyond(p, group[mid], group[mid+1]) ) lo = mid + 1;
+          else hi = mid;
+        }
+        if( best == nullptr or beyond(p, *best, group[lo]) ) best = &group[lo];
+      }
+      if( best == nullptr ) return true;
+      chain.push_back(*best);
+    }
+    return false;
+  }
+
+  /* Chan's algorithm: monotone chains of groups of m points, wrapped into the hull in
+   * at most m steps per chain, squaring m until the hull fits. Points off their group's
+   * chains cannot be on the hull, so each failed round only hands the group chains on
+   * to the next. Runs in O(n log h) and returns the same chains as convex_hull. Assumes
+   * that input points are unique and reorders them within groups. */
+  template<typename T> pair< Chain<T>, Chain<T> > output_sensitive_convex_hull
+    (std::span< Point <T> > polygon, bool collinear = false) {
+      std::vector< Point<T> > survivors;
+      if( polygon.size() >= prefilter_threshold ) polygon = polygon.first(prefilter(polygon));
+      for(std::size_t m = 16; ; m = m * m) {
+        std::size_t n = polygon.size();
+        if( m >= n ) return convex_hull(polygon, false, collinear);
+
+        std::vector< Chain<T> > lower_groups, upper_groups;
+        for(std::size_t first = 0; first < n; first += m) {
+          auto [lower_chain, upper_chain] = convex_hull(polygon.subspan(first, std::min(m, n - first)), false, collinear);
+          lower_groups.emplace_back(std::move(lower_chain));
+          upper_groups.emplace_back(std::move(upper_chain));
+        }
+
+        Chain<T> lower_chain, upper_chain;
+        if( __wrap_chain(lower_groups, true, collinear, m, lower_chain) and
+            __wrap_chain(upper_groups, false, collinear, m, upper_chain) )
+          return pair<Chain<T>, Chain<T>>{lower_chain, upper_chain};
+
+        std::vector< Point<T> > next;
+        for(std::size_t group = 0; group < lower_groups.size(); group++) {
+          auto const& lower_group = lower_groups[group], upper_group = upper_groups[group];
+          next.insert(next.end(), lower_group.begin(), lower_group.end());
+          std::set_difference(upper_group.begin(), upper_group.end(),
+              lower_group.begin(), lower_group.end(), std::back_inserter(next));
+        }
+        survivors = std::move(next), polygon = survivors;
+      }
+    }
+
+  template<typename T> pair< Chain<T>, Chain<T> > output_sensitive_convex_hull
+    (vector< Point <T> > polygon, bool collinear = false) {
+      return output_sensitive_convex_hull(std::span< Point<T> >(polygon), collinear);
+    }
+
+}; // end namespace dpch
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/util/ForkJoin.hh>
+#include <dpch/static/RadixSort.hh>
+#include <dpch/static/Prefilter.hh>
+#include <dpch/static/ConvexHull.hh>
+
+namespace dpch {
+
+  /* Whether the monotone chain drops b when c follows a and b. */
+  template<typename T> inline bool drops_middle(Point<T> const& a, Point<T> const& b, Point<T> const& c,
+      bool lower, bool collinear) {
+    auto turn = orientation(a, b, c);
+    if( lower ) return collinear ? turn < 0 : turn <= 0;
+    return collinear ? turn > 0 : turn >= 0;
+  }
+
+  /* Joins two chains whose points are lexicographically separated by walking
+   * the bridge inwards from the last point of left and the first point of right. */
+  template<typename T> Chain<T> merge_chains(Chain<T> const& left, Chain<T> const& right,
+      bool lower, bool collinear) {
+    std::size_t i = left.size() - 1, j = 0;
+    for(bool moved = true; moved; ) {
+      moved = false;
+      while( i > 0 and drops_middle(left[i-1], left[i], right[j], lower, collinear) ) i--, moved = true;
+      while( j + 1 < right.size() and drops_middle(left[i], right[j], right[j+1], lower, collinear) ) j++, moved = true;
+    }
+    Chain<T> chain;
+    chain.reserve(i + 1 + right.size() - j);
+    chain.insert(chain.end(), left.begin(), left.begin() + i + 1);
+    chain.insert(chain.end(), right.begin() + j, right.end());
+    return chain;
+  }
+
+  /* Monotone chains of sorted, grain sized chunks, merged pairwise up the recursion. */
+  template<typename T> pair< Chain<T>, Chain<T> > __parallel_convex_hull(std::span< Point<T> > polygon,
+      ForkJoin& pool, std::size_t grain, bool collinear) {
+    if( polygon.size() <= grain ) return convex_hull(polygon, true, collinear);
+    pair< Chain<T>, Chain<T> > left, right;
+    auto middle = polygon.size() / 2;
+    pool.fork([&] { left = __parallel_convex_hull(polygon.first(middle), pool, grain, collinear); },
+        [&] { right = __parallel_convex_hull(polygon.subspan(middle), pool, grain, collinear); });
+    return pair< Chain<T>, Chain<T> >{
+      merge_chains(left.first, right.first, true, collinear),
+        merge_chains(left.second, right.second, false, collinear)};
+  }
+
+  /* Multi-threaded counterpart of convex_hull; prefilters and sorts the points in
+   * place, with a radix sort when the coordinates are integers. */
+  template<typename T> pair< Chain<T>, Chain<T> > parallel_convex_hull(std::span< Point<T> > polygon,
+      unsigned threads = std::thread::hardware_concurrency(), bool sorted = false, bool collinear = false) {
+    ForkJoin pool(threads);
+    if( polygon.size() >= prefilter_threshold ) polygon = polygon.first(prefilter(polygon));
+    if( not sorted ) sort_points(polygon, pool);
+    std::size_t grain = pool.threads() == 1 ? polygon.size() :
+      std::max< std::size_t >(1 << 12, polygon.size() / (4 * pool.threads()) + 1);
+    return __parallel_convex_hull(polygon, pool, grain, collinear);
+  }
+
+}; // end namespace dpch
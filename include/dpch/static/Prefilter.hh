@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <dpch/util/Point.hh>
+
+namespace dpch {
+
+  /* Inputs smaller than this go straight to the hull. */
+  constexpr std::size_t prefilter_threshold = 1024;
+
+  /* Convex polygon of the extreme input points in the eight compass directions,
+   * counterclockwise, as edges origin + t * direction in double precision. */
+  struct PrefilterPolygon {
+    std::vector< Point<double> > origins, directions;
+    double bound = 0; // cross products at or below this may be rounding noise
+  };
+
+  template<typename T> PrefilterPolygon __prefilter_polygon(std::span< Point<T> const > points) {
+    std::array< std::size_t, 8 > extremes{};
+    std::array< double, 8 > keys;
+    keys.fill(-INFINITY);
+    double max_x = 0, max_y = 0;
+    for(std::size_t i = 0; i < points.size(); i++) {
+      double x = double(points[i].x), y = double(points[i].y);
+      double candidates[8] = { -y, x - y, x, x + y, y, y - x, -x, -x - y };
+      for(int k = 0; k < 8; k++)
+        if( candidates[k] > keys[k] ) keys[k] = candidates[k], extremes[k] = i;
+      max_x = std::max(max_x, std::abs(x)), max_y = std::max(max_y, std::abs(y));
+    }
+
+    /* Strict monotone chain over at most eight points. Any polygon on input points
+     * lies inside the hull, so the floating point turns only need to be sensible. */
+    std::vector< Point<double> > corners;
+    for(auto index: extremes) corners.emplace_back(double(points[index].x), double(points[index].y));
+    std::sort(corners.begin(), corners.end());
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+    std::vector< Point<double> > polygon;
+    for(int half = 0; half < 2; half++) {
+      std::size_t base = polygon.size();
+      for(auto const& corner: corners) {
+        while( polygon.size() >= base + 2 and
+            (polygon.back() - polygon[polygon.size()-2]) * (corner - polygon.back()) <= 0 )
+          polygon.pop_back();
+        polygon.push_back(corner);
+      }
+      polygon.pop_back();
+      std::reverse(corners.begin(), corners.end());
+    }
+
+    PrefilterPolygon result;
+    if( polygon.size() < 3 ) return result;
+    for(std::size_t k = 0; k < polygon.size(); k++) {
+      result.origins.push_back(polygon[k]);
+      result.directions.push_back(polygon[(k + 1) % polygon.size()] - polygon[k]);
+    }
+    /* Differences of converted coordinates are off by a few ulps of the largest
+     * coordinate, so a generous multiple of that bounds the error of each cross product. */
+    result.bound = std::ldexp(max_x * max_y, -44);
+    return result;
+  }
+
+  /* Rejects points strictly inside the extreme polygon: they are neither hull vertices
+   * nor on the hull boundary. Survivors are moved to the front in their original order
+   * and their count is returned; the rejected points end up permuted behind them. */
+  template<typename T> std::size_t prefilter(std::span< Point<T> > points) {
+    auto polygon = __prefilter_polygon(std::span< Point<T> const >(points));
+    std::size_t n = points.size(), edges = polygon.origins.size(), kept = 0, i = 0;
+    if( edges == 0 ) return n;
+
+#if defined(__AVX2__)
+    if constexpr ( std::is_same_v<T, double> or std::is_same_v<T, int32_t> ) {
+      static_assert( sizeof(Point<T>) == 2 * sizeof(T) );
+      auto load = [&] (std::size_t first) {
+        if constexpr ( std::is_same_v<T, double> )
+          return _mm256_loadu_pd(&points[first].x);
+        else return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&points[first].x)));
+      };
+      __m256d bound = _mm256_set1_pd(polygon.bound);
+      for(; i + 4 <= n; i += 4) {
+        __m256d low = load(i), high = load(i + 2); // x0 y0 x1 y1, x2 y2 x3 y3
+        __m256d xs = _mm256_permute4x64_pd(_mm256_unpacklo_pd(low, high), 0b11011000);
+        __m256d ys = _mm256_permute4x64_pd(_mm256_unpackhi_pd(low, high), 0b11011000);
+        __m256d inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for(std::size_t k = 0; k < edges; k++) {
+          auto const& origin = polygon.origins[k];
+          auto const& direction = polygon.directions[k];
+          __m256d dx = _mm256_sub_pd(xs, _mm256_set1_pd(origin.x));
+          __m256d dy = _mm256_sub_pd(ys, _mm256_set1_pd(origin.y));
+          __m256d cross = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(direction.x), dy),
+              _mm256_mul_pd(_mm256_set1_pd(direction.y), dx));
+          inside = _mm256_and_pd(inside, _mm256_cmp_pd(cross, bound, _CMP_GT_OQ));
+        }
+        int mask = _mm256_movemask_pd(inside);
+        for(int lane = 0; lane < 4; lane++)
+          if( not (mask >> lane & 1) ) std::swap(points[kept++], points[i + lane]);
+      }
+    }
+#endif
+
+    /* Branchless over the edges so that the inner loop vectorizes. */
+    for(; i < n; i++) {
+      double x = double(points[i].x), y = double(points[i].y);
+      bool inside = true;
+      for(std::size_t k = 0; k < edges; k++) {
+        auto const& origin = polygon.origins[k];
+        auto const& direction = polygon.directions[k];
+        inside &= direction.x * (y - origin.y) - direction.y * (x - origin.x) > polygon.bound;
+      }
+      if( not inside ) std::swap(points[kept++], points[i]);
+    }
+    return kept;
+  }
+
+}; // end namespace dpch
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/ForkJoin.hh>
+
+namespace dpch {
+
+  /* Maps an integer to an unsigned key with the same order. */
+  template<typename T> inline std::make_unsigned_t<T> radix_key(T value) {
+    using key_t = std::make_unsigned_t<T>;
+    if constexpr ( std::is_signed_v<T> )
+      return key_t(value) ^ (key_t(1) << (8 * sizeof(T) - 1));
+    else return value;
+  }
+
+  /* Sorts points lexicographically with an LSD radix sort, y first and then x, over
+   * bytes or, once the input dwarfs the counters, 16 bit digits.
+   * Each pass counts digits per chunk and scatters the chunks in parallel, and a
+   * pass is skipped whenever every point has the same digit. */
+  template<typename T> void radix_sort(std::span< Point<T> > points, ForkJoin& pool) {
+    static_assert( std::is_integral_v<T> );
+    constexpr int bits = 8 * sizeof(T);
+    std::size_t n = points.size(), n_chunks = std::max< std::size_t >(1, std::min< std::size_t >(pool.threads(), n >> 14));
+    if( n <= 64 ) return std::sort(points.begin(), points.end());
+    int width = std::min(bits, n >= (1 << 20) ? 16 : 8), passes = bits / width;
+    std::size_t digits = std::size_t(1) << width;
+
+    std::vector< Point<T> > buffer(n);
+    std::span< Point<T> > from = points, to = buffer;
+    std::vector< std::vector<std::size_t> > counts(n_chunks, std::vector<std::size_t>(digits));
+    auto chunk_begin = [&] (std::size_t chunk) { return n * chunk / n_chunks; };
+
+    for(int pass = 0; pass < 2 * passes; pass++) {
+      int shift = width * (pass % passes);
+      auto digit = [&] (Point<T> const& point) {
+        return (radix_key(pass < passes ? point.y : point.x) >> shift) & (digits - 1);
+      };
+
+      parallel_for(pool, 0, n_chunks, [&] (std::size_t chunk) {
+          std::fill(counts[chunk].begin(), counts[chunk].end(), 0);
+          for(std::size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+            counts[chunk][digit(from[i])]++;
+          });
+
+      std::size_t offset = 0;
+      bool trivial = false;
+      for(std::size_t d = 0; d < digits; d++) {
+        std::size_t total = 0;
+        for(auto &count: counts) total += count[d];
+        if( total == n ) { trivial = true; break; }
+        for(auto &count: counts) {
+          auto next = offset + count[d];
+          count[d] = offset, offset = next;
+        }
+      }
+      if( trivial ) continue;
+
+      parallel_for(pool, 0, n_chunks, [&] (std::size_t chunk) {
+          auto &offsets = counts[chunk];
+          for(std::size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+            to[offsets[digit(from[i])]++] = from[i];
+          });
+      std::swap(from, to);
+    }
+
+    if( from.data() != points.data() ) std::copy(from.begin(), from.end(), points.begin());
+  }
+
+  /* Sorts points lexicographically: radix sort for integer coordinates, a parallel
+   * comparison sort otherwise. */
+  template<typename T> void sort_points(std::span< Point<T> > points, ForkJoin& pool) {
+    if constexpr ( std::is_integral_v<T> ) radix_sort(points, pool);
+    else parallel_sort(pool, points.begin(), points.end());
+  }
+
+}; // end namespace dpch
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/FieldTraits.hh>
+
+namespace dpch {
+
+  /* An aggregate of a run of elements, kept on every treap node for its subtree:
+   * one is made from each element, and add() appends the summary of the run that
+   * follows. This one summarises to nothing, and is what arrays and hulls keep unless
+   * they are given another. */
+  template<typename Element> struct ArraySummary {
+    ArraySummary() = default;
+    explicit ArraySummary(Element const&) { }
+    void add(ArraySummary const&) { }
+  };
+
+  /* The shoelace terms, lengths and first moments of a chain of segments, from
+   * which the area, perimeter and centroid of a polygon made of chains follow.
+   * The shoelace and moment sums are exact in cross_t and moment_t, so that the
+   * moments of a small polygon far from the origin do not cancel; lengths are
+   * accumulated in double. Hulls keep it when given it as their summary, at the
+   * cost of a few wide additions per node on every cut and join. */
+  template<typename Field> struct ChainSummary {
+    using cross_t = typename FieldTraits<Field>::cross_t;
+    using moment_t = typename FieldTraits<Field>::moment_t;
+
+    cross_t twice_area = 0;                        // sum of cross(u, v)
+    double length = 0;                             // sum of |v - u|
+    moment_t moment_x = 0, moment_y = 0;           // sums of (u + v) * cross(u, v)
+
+    ChainSummary() = default;
+    explicit ChainSummary(LineSegment<Field> const& segment) : twice_area(cross(segment.u, segment.v)),
+      moment_x(moment<Field>(twice_area, segment.u.x + segment.v.x)),
+      moment_y(moment<Field>(twice_area, segment.u.y + segment.v.y)) {
+      double dx = double(segment.v.x - segment.u.x), dy = double(segment.v.y - segment.u.y);
+      length = std::sqrt(dx * dx + dy * dy);
+    }
+    void add(ChainSummary const& other) {
+      twice_area += other.twice_area, length += other.length;
+      moment_x += other.moment_x, moment_y += other.moment_y;
+    }
+  };
+
+  /* The polygon bounded by a lower and an upper chain, both running left to right.
+   * A polygon without area is the segment between its extreme points, walked there
+   * and back, and its centroid is the middle of that segment. */
+  template<typename Field> struct HullMeasures {
+    ChainSummary<Field> lower, upper;
+    Point<Field> leftmost, rightmost;
+
+    typename FieldTraits<Field>::cross_t twice_area() const { return lower.twice_area - upper.twice_area; }
+    double area() const { return double(twice_area()) / 2; }
+    double perimeter() const { return lower.length + upper.length; }
+    Point<double> centroid() const {
+      if( twice_area() == 0 )
+        return Point<double>((double(leftmost.x) + double(rightmost.x)) / 2, (double(leftmost.y) + double(rightmost.y)) / 2);
+      double scale = 3 * double(twice_area());
+      return Point<double>(double(lower.moment_x - upper.moment_x) / scale, double(lower.moment_y - upper.moment_y) / scale);
+    }
+  };
+
+}; // end namespace dpch
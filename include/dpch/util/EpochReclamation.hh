@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dpch {
+
+  /* Epoch based reclamation for a single writer and a bounded number of readers.
+   * A reader pins the current epoch before it loads a shared pointer and clears its
+   * slot when done; the writer retires what it unpublished at the current epoch and
+   * frees it once every pinned reader has moved past that epoch. Readers only ever
+   * write their own cache line. */
+  class EpochDomain {
+    public:
+      class Reader;
+      class Guard;
+
+      explicit EpochDomain(unsigned max_readers = 128)
+        : slots(new Slot[max_readers]), n_slots(max_readers) { }
+      ~EpochDomain() { for(auto const& object: retired) object.destroy(object.object); }
+
+      EpochDomain(EpochDomain const&) = delete;
+      EpochDomain& operator=(EpochDomain const&) = delete;
+
+      template<typename T> void retire(T const*);
+      void collect();
+
+      std::size_t get_retired_count() const { return retired.size(); }
+
+    private:
+      static constexpr uint64_t idle = ~uint64_t(0);
+
+      struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{idle};
+        std::atomic<bool> taken{false};
+      };
+
+      struct Retired {
+        uint64_t epoch;
+        void const* object;
+        void (*destroy)(void const*);
+      };
+
+      std::unique_ptr<Slot[]> slots;
+      unsigned n_slots;
+      std::atomic<uint64_t> epoch{0};
+      std::vector<Retired> retired;
+  };
+
+  /* Owns one reader slot of a domain, waiting for one to free up if all are taken;
+   * a thread keeps one for as long as it reads. */
+  class EpochDomain::Reader {
+    public:
+      explicit Reader(EpochDomain& _domain) : domain(&_domain) {
+        for(unsigned index = 0; slot == nullptr; index = (index + 1) % domain->n_slots) {
+          bool expected = false;
+          if( domain->slots[index].taken.compare_exchange_strong(expected, true) )
+            slot = &domain->slots[index];
+        }
+      }
+      ~Reader() { if( slot != nullptr ) slot->taken.store(false, std::memory_order_release); }
+
+      Reader(Reader&& other) : domain(other.domain), slot(other.slot) { other.slot = nullptr; }
+      Reader(Reader const&) = delete;
+      Reader& operator=(Reader const&) = delete;
+
+      Guard pin() const;
+
+    private:
+      friend class Guard;
+      EpochDomain* domain;
+      Slot* slot = nullptr;
+  };
+
+  /* Keeps everything retired from the pinned epoch on alive until destroyed. */
+  class EpochDomain::Guard {
+    public:
+      explicit Guard(Slot* _slot, std::atomic<uint64_t> const& epoch) : slot(_slot) {
+        assert( slot->epoch.load(std::memory_order_relaxed) == idle ); // pins do not nest
+        slot->epoch.store(epoch.load());
+      }
+      ~Guard() { slot->epoch.store(idle, std::memory_order_release); }
+
+      Guard(Guard const&) = delete;
+      Guard& operator=(Guard const&) = delete;
+
+    private:
+      Slot* slot;
+  };
+
+  inline EpochDomain::Guard EpochDomain::Reader::pin() const { return Guard(slot, domain->epoch); }
+
+  template<typename T> void EpochDomain::retire(T const* object) {
+    if( object == nullptr ) return;
+    retired.push_back({epoch.fetch_add(1), object, [](void const* object) { delete static_cast<T const*>(object); }});
+  }
+
+  /* Frees whatever was retired before the oldest pinned epoch. */
+  inline void EpochDomain::collect() {
+    uint64_t oldest = idle;
+    for(unsigned index = 0; index < n_slots; index++)
+      oldest = std::min(oldest, slots[index].epoch.load());
+    std::size_t kept = 0;
+    for(auto const& object: retired) {
+      if( object.epoch < oldest ) object.destroy(object.object);
+      else retired[kept++] = object;
+    }
+    retired.resize(kept);
+  }
+
+}; // end namespace dpch
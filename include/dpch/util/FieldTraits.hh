@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/Int256.hh>
+
+namespace dpch {
+
+  /* Points are stored in Field, and predicates are evaluated in wider types picked at
+   * compile time: cross_t for cross and dot products of coordinate differences, and
+   * bridge_t for the bridge test of the mergeable hulls, a product of three coordinates,
+   * and moment_t for sums of first moments of polygons, a coordinate times a cross product.
+   * Differences themselves are taken in Field. So predicates are exact as long as
+   * coordinates are below a quarter of the range of Field in magnitude: 2^30 for int32_t
+   * and 2^62 for int64_t. The int64_t bridge test only stays exact below 2^41. Other
+   * fields compute everything in Field. */
+  template<typename Field> struct FieldTraits {
+    using cross_t  = Field;
+    using bridge_t = Field;
+    using moment_t = Field;
+  };
+
+  template<> struct FieldTraits<int16_t> {
+    using cross_t  = int32_t;
+    using bridge_t = int64_t;
+    using moment_t = int64_t;
+  };
+
+#ifdef __SIZEOF_INT128__
+  template<> struct FieldTraits<int32_t> {
+    using cross_t  = int64_t;
+    using bridge_t = __int128;
+    using moment_t = __int128;
+  };
+
+  template<> struct FieldTraits<int64_t> {
+    using cross_t  = __int128;
+    using bridge_t = __int128;
+    using moment_t = Int256;
+  };
+#else
+  template<> struct FieldTraits<int32_t> {
+    using cross_t  = int64_t;
+    using bridge_t = int64_t;
+    using moment_t = double;
+  };
+#endif
+
+  /* Cross and dot products in the predicate type of Field. */
+  template<typename Field> inline typename FieldTraits<Field>::cross_t
+    cross(Point<Field> const& p, Point<Field> const& q) {
+      using cross_t = typename FieldTraits<Field>::cross_t;
+      return cross_t(p.x) * q.y - cross_t(q.x) * p.y;
+    }
+
+  template<typename Field> inline typename FieldTraits<Field>::cross_t
+    dot(Point<Field> const& p, Point<Field> const& q) {
+      using cross_t = typename FieldTraits<Field>::cross_t;
+      return cross_t(p.x) * q.x + cross_t(p.y) * q.y;
+    }
+
+  /* The first moment term c * s of a cross product c and a coordinate sum s, in moment_t. */
+  template<typename Field> inline typename FieldTraits<Field>::moment_t
+    moment(typename FieldTraits<Field>::cross_t c, Field s) {
+      using moment_t = typename FieldTraits<Field>::moment_t;
+      return moment_t(c) * s;
+    }
+
+#ifdef __SIZEOF_INT128__
+  template<> inline Int256 moment<int64_t>(__int128 c, int64_t s) { return Int256::product(c, s); }
+#endif
+
+}; // end namespace dpch
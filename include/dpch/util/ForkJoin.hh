@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dpch {
+
+  class ForkJoin;
+
+  /* Worker threads shared by every ForkJoin, started as they are first needed and
+   * kept until exit. Each worker has a deque of tasks, and threads outside the pool
+   * share one more: a thread pushes its forks at the back and takes them back from
+   * there, while idle threads steal from the front, where the oldest and largest
+   * tasks are. A task only runs on a thread the budget of its ForkJoin allows. */
+  class WorkerPool {
+    public:
+      struct Task {
+        void (*run)(void const*);
+        void const* closure;
+        ForkJoin* owner;
+        std::atomic<bool> done{false};
+      };
+
+      static constexpr unsigned max_workers = 255;
+
+      static WorkerPool& instance() { static WorkerPool pool; return pool; }
+
+      ~WorkerPool();
+
+      /* Starts workers until there are at least count, or max_workers. */
+      void start(unsigned count);
+
+      void push(Task*);
+      /* Whether the task was still in the deque of this thread, and is now out of it. */
+      bool take_back(Task*);
+      /* Runs one task that was stolen, if any: from joining, or from a ForkJoin with budget left. */
+      bool help(ForkJoin* joining);
+
+      unsigned get_workers() const { return n_workers.load(); }
+
+    private:
+      struct alignas(64) Deque {
+        std::mutex mutex;
+        std::deque< Task* > tasks;
+      };
+
+      std::array< Deque, max_workers + 1 > deques; // the first one for threads outside the pool
+      std::atomic<unsigned> n_workers{0};
+      std::vector< std::thread > workers;
+      std::mutex start_mutex;
+
+      // idle workers sleep until a task is pushed or budget is given back
+      std::mutex sleep_mutex;
+      std::condition_variable wake;
+      std::atomic<uint64_t> signals{0};
+      std::atomic<unsigned> sleepers{0};
+      bool stopping = false;
+
+      static Deque*& local() { thread_local Deque* deque = nullptr; return deque; }
+      Deque& own() { return local() == nullptr ? deques[0] : *local(); }
+
+      void signal();
+      void work(unsigned index);
+      void finish(Task*);
+  };
+
+  /* Fork-join over a budget of threads from the WorkerPool, counting the calling
+   * thread. A fork leaves its first task to be stolen by a worker while the budget
+   * lasts, runs the second, and then runs the first itself unless it was stolen; a
+   * thread waiting for a stolen task runs other tasks of the same ForkJoin meanwhile,
+   * so the budget drifts to whichever subtrees are still busy. */
+  class ForkJoin {
+    public:
+      explicit ForkJoin(unsigned threads = std::thread::hardware_concurrency())
+        : _threads(std::clamp(threads, 1u, WorkerPool::max_workers + 1)), spare(int(_threads) - 1) {
+        if( _threads > 1 ) WorkerPool::instance().start(_threads - 1);
+      }
+
+      ForkJoin(ForkJoin const&) = delete;
+      ForkJoin& operator=(ForkJoin const&) = delete;
+
+      unsigned threads() const { return _threads; }
+
+      template<typename Left, typename Right> void fork(Left const& left, Right const& right) {
+        if( _threads == 1 ) { left(), right(); return; }
+        auto& pool = WorkerPool::instance();
+        WorkerPool::Task task{[](void const* closure) { (*static_cast<Left const*>(closure))(); }, &left, this};
+        pool.push(&task);
+        right();
+        if( pool.take_back(&task) ) return left();
+        while( not task.done.load(std::memory_order_acquire) )
+          if( not pool.help(this) ) std::this_thread::yield();
+      }
+
+    private:
+      friend class WorkerPool;
+
+      unsigned _threads;
+      std::atomic<int> spare;
+
+      bool acquire() {
+        int available = spare.load();
+        while( available > 0 and not spare.compare_exchange_weak(available, available - 1) );
+        return available > 0;
+      }
+  };
+
+  inline WorkerPool::~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for(auto& worker: workers) worker.join();
+  }
+
+  inline void WorkerPool::start(unsigned count) {
+    count = std::min(count, max_workers);
+    if( n_workers.load() >= count ) return;
+    std::lock_guard<std::mutex> lock(start_mutex);
+    for(unsigned index = n_workers.load(); index < count; index++) {
+      workers.emplace_back(&WorkerPool::work, this, index);
+      n_workers.store(index + 1);
+    }
+  }
+
+  inline void WorkerPool::push(Task* task) {
+    auto& deque = own();
+    {
+      std::lock_guard<std::mutex> lock(deque.mutex);
+      deque.tasks.push_back(task);
+    }
+    signal();
+  }
+
+  /* Threads outside the pool share their deque, so the task may be under theirs. */
+  inline bool WorkerPool::take_back(Task* task) {
+    auto& deque = own();
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    auto found = std::find(deque.tasks.rbegin(), deque.tasks.rend(), task);
+    if( found == deque.tasks.rend() ) return false;
+    deque.tasks.erase(std::next(found).base());
+    return true;
+  }
+
+  inline bool WorkerPool::help(ForkJoin* joining) {
+    Task* task = nullptr;
+    unsigned n_deques = n_workers.load() + 1;
+    for(unsigned index = 0; index < n_deques and task == nullptr; index++) {
+      auto& deque = deques[index];
+      std::lock_guard<std::mutex> lock(deque.mutex);
+      if( deque.tasks.empty() ) continue;
+      Task* front = deque.tasks.front();
+      if( front->owner != joining and not front->owner->acquire() ) continue;
+      task = front, deque.tasks.pop_front();
+    }
+    if( task == nullptr ) return false;
+    bool borrowed = task->owner != joining;
+    task->run(task->closure);
+    if( borrowed ) task->owner->spare.fetch_add(1);
+    finish(task);
+    return true;
+  }
+
+  /* The task and its ForkJoin may be gone as soon as it is done. */
+  inline void WorkerPool::finish(Task* task) {
+    task->done.store(true, std::memory_order_release);
+    signal();
+  }
+
+  inline void WorkerPool::signal() {
+    signals.fetch_add(1);
+    if( sleepers.load() == 0 ) return;
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    wake.notify_all();
+  }
+
+  inline void WorkerPool::work(unsigned index) {
+    local() = &deques[index + 1];
+    while( true ) {
+      uint64_t seen = signals.load();
+      if( help(nullptr) ) continue;
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      sleepers.fetch_add(1);
+      wake.wait(lock, [&] { return stopping or signals.load() != seen; });
+      sleepers.fetch_sub(1);
+      if( stopping ) return;
+    }
+  }
+
+  /* Calls task(i) for every i in [first, last), splitting the range in halves. */
+  template<typename Task> void parallel_for(ForkJoin& pool, std::size_t first, std::size_t last, Task const& task) {
+    if( last - first <= 1 or pool.threads() == 1 ) {
+      for(; first < last; first++) task(first);
+      return;
+    }
+    std::size_t middle = first + (last - first) / 2;
+    pool.fork([&] { parallel_for(pool, first, middle, task); },
+        [&] { parallel_for(pool, middle, last, task); });
+  }
+
+  /* How many of the first k elements of the merge of a[0, m) and b[0, n) come from
+   * a, ties going to a as in std::merge: the first i with b[k - i - 1] before a[i]. */
+  template<typename Iterator, typename Compare> std::ptrdiff_t __co_rank(std::ptrdiff_t k,
+      Iterator a, std::ptrdiff_t m, Iterator b, std::ptrdiff_t n, Compare const& compare) {
+    std::ptrdiff_t low = std::max< std::ptrdiff_t >(0, k - n), high = std::min(k, m);
+    while( low < high ) {
+      std::ptrdiff_t i = low + (high - low) / 2;
+      if( compare(b[k - i - 1], a[i]) ) high = i;
+      else low = i + 1;
+    }
+    return low;
+  }
+
+  /* Merges the sorted runs [first, middle) and [middle, last) through a buffer, the
+   * output cut into grain sized pieces that co-ranking maps back to pieces of either
+   * run, each merged and moved back as a task of its own. */
+  template<typename Iterator, typename Compare> void parallel_merge(ForkJoin& pool,
+      Iterator first, Iterator middle, Iterator last, Compare const& compare, std::ptrdiff_t grain) {
+    std::ptrdiff_t m = middle - first, n = last - middle, size = m + n;
+    std::vector< typename std::iterator_traits<Iterator>::value_type > merged(size);
+    std::size_t n_pieces = (size + grain - 1) / grain;
+    parallel_for(pool, 0, n_pieces, [&](std::size_t piece) {
+        std::ptrdiff_t begin = piece * grain, end = std::min(size, std::ptrdiff_t(piece + 1) * grain);
+        std::ptrdiff_t i = __co_rank(begin, first, m, middle, n, compare), j = __co_rank(end, first, m, middle, n, compare);
+        std::merge(std::make_move_iterator(first + i), std::make_move_iterator(first + j),
+            std::make_move_iterator(middle + (begin - i)), std::make_move_iterator(middle + (end - j)),
+            merged.begin() + begin, compare);
+        });
+    parallel_for(pool, 0, n_pieces, [&](std::size_t piece) {
+        std::ptrdiff_t begin = piece * grain, end = std::min(size, std::ptrdiff_t(piece + 1) * grain);
+        std::move(merged.begin() + begin, merged.begin() + end, first + begin);
+        });
+  }
+
+  /* Sorts halves in parallel and merges them back in parallel, down to grain sized runs. */
+  template<typename Iterator, typename Compare = std::less<>> void parallel_sort(ForkJoin& pool,
+      Iterator first, Iterator last, Compare const& compare = Compare(), std::ptrdiff_t grain = 1 << 16) {
+    if( pool.threads() == 1 or last - first <= grain )
+      return std::sort(first, last, compare);
+    Iterator middle = first + (last - first) / 2;
+    pool.fork([&] { parallel_sort(pool, first, middle, compare, grain); },
+        [&] { parallel_sort(pool, middle, last, compare, grain); });
+    parallel_merge(pool, first, middle, last, compare, grain);
+  }
+
+}; // end namespace dpch
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace dpch {
+
+  /* Counters of the work behind updates, to tell which merge made an operation slow.
+   * They are kept only when DPCH_INSTRUMENT is defined: otherwise every hook below
+   * compiles to nothing, stats stay zero and traces are never called. An update opens
+   * a scope that points the hooks of this thread, in whichever structure they sit, to
+   * the counters of the operation; on closing, the scope adds them to the stats of the
+   * instance and hands them to its trace callback. Nested operations count towards the
+   * outermost one, and work on the helper threads of a parallel merge is not counted. */
+  struct HullStats {
+    uint64_t operations = 0;
+    uint64_t pushes = 0, pulls = 0;         // splits and merges of the hulls of DynamicHull branches
+    uint64_t bridges = 0, bridge_steps = 0; // find_{lower,upper}_bridge calls and loop iterations
+    uint64_t allocated = 0, freed = 0;      // nodes of the hull treaps and segment arrays
+    uint64_t cuts = 0, joins = 0;           // cuts and joins of treaps, not counting recursion
+    uint32_t cut_depth = 0, join_depth = 0; // deepest recursion of a cut and of a join
+    uint32_t height = 0;                    // deepest level of the hull treap an update reached
+
+    void add(HullStats const& other) {
+      operations += other.operations, pushes += other.pushes, pulls += other.pulls;
+      bridges += other.bridges, bridge_steps += other.bridge_steps;
+      allocated += other.allocated, freed += other.freed, cuts += other.cuts, joins += other.joins;
+      cut_depth = std::max(cut_depth, other.cut_depth), join_depth = std::max(join_depth, other.join_depth);
+      height = std::max(height, other.height);
+    }
+  };
+
+  /* One operation, as handed to a trace callback. */
+  struct HullTrace {
+    char const* operation;
+    HullStats work;
+    uint64_t nanoseconds;
+  };
+
+  using trace_callback_t = std::function< void(HullTrace const&) >;
+
+  /* The counters the hooks of this thread write to, if any. */
+  inline thread_local HullStats* __instrument_current = nullptr;
+
+  class __InstrumentScope {
+    public:
+      __InstrumentScope(HullStats& _stats, trace_callback_t const& _trace, char const* _operation)
+        : stats(_stats), trace(_trace), operation(_operation), outermost(__instrument_current == nullptr) {
+        if( not outermost ) return;
+        work.operations = 1;
+        __instrument_current = &work;
+        start = std::chrono::steady_clock::now();
+      }
+      ~__InstrumentScope() {
+        if( not outermost ) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        __instrument_current = nullptr;
+        stats.add(work);
+        if( trace ) trace({operation, work,
+            uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())});
+      }
+
+    private:
+      HullStats& stats;
+      trace_callback_t const& trace;
+      char const* operation;
+      bool outermost;
+      HullStats work;
+      std::chrono::steady_clock::time_point start;
+  };
+
+  /* Tracks the depth of a recursion, one per counter and thread, and counts its
+   * outermost calls if given a counter for them. */
+  template<uint32_t HullStats::*Depth, uint64_t HullStats::*Calls = nullptr> class __InstrumentLevel {
+    public:
+      __InstrumentLevel() {
+        level++;
+        if( __instrument_current == nullptr ) return;
+        __instrument_current->*Depth = std::max(__instrument_current->*Depth, level);
+        if constexpr( Calls != nullptr ) if( level == 1 ) ++(__instrument_current->*Calls);
+      }
+      ~__InstrumentLevel() { level--; }
+
+    private:
+      static inline thread_local uint32_t level = 0;
+  };
+
+}; // end namespace dpch
+
+#ifdef DPCH_INSTRUMENT
+#define DPCH_COUNT(counter) (::dpch::__instrument_current ? void(++::dpch::__instrument_current->counter) : void())
+#define DPCH_LEVEL(depth) ::dpch::__InstrumentLevel< &::dpch::HullStats::depth > __instrument_##depth
+#define DPCH_RECURSION(calls, depth) \
+  ::dpch::__InstrumentLevel< &::dpch::HullStats::depth, &::dpch::HullStats::calls > __instrument_##depth
+#define DPCH_OPERATION(stats, trace, name) ::dpch::__InstrumentScope __instrument_scope(stats, trace, name)
+#else
+#define DPCH_COUNT(counter) ((void)0)
+#define DPCH_LEVEL(depth) ((void)0)
+#define DPCH_RECURSION(calls, depth) ((void)0)
+#define DPCH_OPERATION(stats, trace, name) ((void)0)
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dpch {
+
+#ifdef __SIZEOF_INT128__
+
+  /* A 256 bit two's complement integer as two 128 bit halves, with just what sums of
+   * products of a 128 bit and a 64 bit integer need: such products, sums and
+   * differences, all modulo 2^256, and a conversion to double. */
+  class Int256 {
+    public:
+      Int256() = default;
+      Int256(__int128 value) : lo(value), hi(value < 0 ? ~(unsigned __int128)0 : 0) { }
+
+      /* a * b exactly: the product of the high word of a by b, a word up, plus that
+       * of its low word. */
+      static Int256 product(__int128 a, int64_t b) {
+        __int128 high = __int128(int64_t(a >> 64)) * b, low = __int128(uint64_t(a)) * b;
+        Int256 result;
+        result.lo = (unsigned __int128)high << 64, result.hi = (unsigned __int128)(high >> 64);
+        return result += Int256(low);
+      }
+
+      Int256& operator+=(Int256 const& other) {
+        lo += other.lo;
+        hi += other.hi + (lo < other.lo);
+        return *this;
+      }
+
+      Int256 operator-() const {
+        Int256 negated;
+        negated.lo = ~lo + 1, negated.hi = ~hi + (negated.lo == 0);
+        return negated;
+      }
+
+      Int256& operator-=(Int256 const& other) { return *this += -other; }
+
+      friend Int256 operator+(Int256 a, Int256 const& b) { return a += b; }
+      friend Int256 operator-(Int256 a, Int256 const& b) { return a -= b; }
+      friend bool operator==(Int256 const&, Int256 const&) = default;
+
+      bool is_negative() const { return __int128(hi) < 0; }
+
+      /* The nearest double but for an ulp or two. */
+      explicit operator double() const {
+        if( is_negative() ) return -double(-*this);
+        return double(hi) * 0x1p128 + double(lo);
+      }
+
+    private:
+      unsigned __int128 lo = 0, hi = 0;
+  };
+
+#endif
+
+}; // end namespace dpch
@@ -9,7 +9,7 @@ namespace dpch {
       LineSegment() { }
       LineSegment(Point<Field> const&_u) : u(_u), v(_u) { }
       LineSegment(Point<Field> const&_u, Point<Field> const&_v) : u(_u), v(_v) { }
-      bool operator==(LineSegment<Field> const&);
+      bool operator==(LineSegment<Field> const&) const;
       LineSegment operator~();
     };
 
@@ -19,7 +19,7 @@ namespace dpch {
   template<typename T> LineSegment<T> LineSegment<T>::operator~()
   { return LineSegment<T>(-v, -u); }
 
-  template<typename T> bool LineSegment<T>::operator==(LineSegment<T> const&s)
+  template<typename T> bool LineSegment<T>::operator==(LineSegment<T> const&s) const
   { return u == s.u and v == s.v; }
 
 }; // end namespace dpch
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/FieldTraits.hh>
+
+namespace dpch {
+
+  /* Geometric predicates. Each returns a value with the sign of the exact answer, to
+   * be compared against zero only. Integral fields evaluate them in the wider types of
+   * FieldTraits. Doubles are evaluated in floating point against a static error bound
+   * first, and recomputed exactly with floating point expansions only when the bound
+   * cannot settle the sign. Overflow and underflow are not accounted for. */
+
+  /* (p - o) * (q - o): positive when o, p, q turn counterclockwise. */
+  template<typename Field> inline auto orientation(
+      Point<Field> const& o, Point<Field> const& p, Point<Field> const& q)
+  { return cross(p - o, q - o); }
+
+  /* (v - u) ^ direction: positive when moving from u to v heads along direction. */
+  template<typename Field> inline auto projection(
+      Point<Field> const& u, Point<Field> const& v, Point<Field> const& direction)
+  { return dot(v - u, direction); }
+
+  /* The bridge test of the mergeable hulls: the height at x = split of the line through
+   * left minus that of the line through right, scaled by the absolute product of the
+   * x extents of the segments so that it needs no division. Meaningless if either
+   * segment is vertical. */
+  template<typename Field> inline auto split_order(
+      LineSegment<Field> const& left, LineSegment<Field> const& right, Field const& split) {
+    using bridge_t = typename FieldTraits<Field>::bridge_t;
+    auto dl  = left.v - left.u, dr = right.u - right.v;
+    auto tlx = (split - left.u.x), trx = (split - right.v.x);
+    // left.u.y + tlx * dl.y / dl.x against right.v.y + trx * dr.y / dr.x
+    auto lhs = bridge_t(dr.x) * (bridge_t(dl.x) * left.u.y + bridge_t(tlx) * dl.y),
+         rhs = bridge_t(dl.x) * (bridge_t(dr.x) * right.v.y + bridge_t(trx) * dr.y);
+    return bridge_t(dr.x) * dl.x <= 0 ? rhs - lhs : lhs - rhs;
+  }
+
+  /* Exact arithmetic: a sum of products is accumulated into an expansion, a sum of
+   * doubles with nonoverlapping mantissas kept in increasing order of magnitude and
+   * without zeros, after Shewchuk. Its last term carries the sign of the sum. */
+  inline void __two_sum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    double b_virtual = sum - a, a_virtual = sum - b_virtual;
+    error = (a - a_virtual) + (b - b_virtual);
+  }
+
+  inline void __accumulate(double *expansion, int &size, double term) {
+    int grown = 0;
+    for(int i = 0; i < size; i++) {
+      double error;
+      __two_sum(term, expansion[i], term, error);
+      if( error != 0 ) expansion[grown++] = error;
+    }
+    if( term != 0 ) expansion[grown++] = term;
+    size = grown;
+  }
+
+  inline void __accumulate(double *expansion, int &size, double a, double b) {
+    double product = a * b;
+    __accumulate(expansion, size, std::fma(a, b, -product));
+    __accumulate(expansion, size, product);
+  }
+
+  inline void __accumulate(double *expansion, int &size, double a, double b, double c) {
+    double product = a * b;
+    __accumulate(expansion, size, std::fma(a, b, -product), c);
+    __accumulate(expansion, size, product, c);
+  }
+
+  /* Half an ulp of one, the relative error of a single rounding. */
+  constexpr double __epsilon = std::numeric_limits<double>::epsilon() / 2;
+
+  /* The exact fallbacks expand every difference into products of coordinates. */
+  [[gnu::noinline]] inline double __exact_orientation(
+      Point<double> const& o, Point<double> const& p, Point<double> const& q) {
+    double expansion[12];
+    int size = 0;
+    __accumulate(expansion, size, p.x, q.y), __accumulate(expansion, size, -p.x, o.y);
+    __accumulate(expansion, size, -o.x, q.y), __accumulate(expansion, size, -p.y, q.x);
+    __accumulate(expansion, size, p.y, o.x), __accumulate(expansion, size, o.y, q.x);
+    return size == 0 ? 0 : expansion[size - 1];
+  }
+
+  [[gnu::noinline]] inline double __exact_projection(
+      Point<double> const& u, Point<double> const& v, Point<double> const& direction) {
+    double expansion[8];
+    int size = 0;
+    __accumulate(expansion, size, v.x, direction.x), __accumulate(expansion, size, -u.x, direction.x);
+    __accumulate(expansion, size, v.y, direction.y), __accumulate(expansion, size, -u.y, direction.y);
+    return size == 0 ? 0 : expansion[size - 1];
+  }
+
+  /* lhs - rhs, with lhs = (c.x - d.x) (b.x a.y + s b.y - s a.y - a.x b.y)
+   *              and rhs = (b.x - a.x) (c.x d.y + s c.y - s d.y - d.x c.y). */
+  [[gnu::noinline]] inline double __exact_split_order(
+      LineSegment<double> const& left, LineSegment<double> const& right, double s) {
+    auto const &a = left.u, &b = left.v, &c = right.u, &d = right.v;
+    double expansion[64];
+    int size = 0;
+    for(auto [scale, sign]: { std::pair(c.x, 1.0), std::pair(d.x, -1.0) }) {
+      __accumulate(expansion, size, sign * scale, b.x, a.y), __accumulate(expansion, size, sign * scale, s, b.y);
+      __accumulate(expansion, size, -sign * scale, s, a.y), __accumulate(expansion, size, -sign * scale, a.x, b.y);
+    }
+    for(auto [scale, sign]: { std::pair(b.x, -1.0), std::pair(a.x, 1.0) }) {
+      __accumulate(expansion, size, sign * scale, c.x, d.y), __accumulate(expansion, size, sign * scale, s, c.y);
+      __accumulate(expansion, size, -sign * scale, s, d.y), __accumulate(expansion, size, -sign * scale, d.x, c.y);
+    }
+    return size == 0 ? 0 : expansion[size - 1];
+  }
+
+  /* The floating point stage of orientation alone, NaN where the bound cannot settle
+   * the sign. It has no branches, so that loops over many triples vectorize. */
+  inline double __filtered_orientation(Point<double> const& o, Point<double> const& p, Point<double> const& q) {
+    constexpr double error_bound = (3 + 16 * __epsilon) * __epsilon;
+    double left = (p.x - o.x) * (q.y - o.y), right = (p.y - o.y) * (q.x - o.x);
+    double det = left - right;
+    return std::abs(det) > error_bound * (std::abs(left) + std::abs(right)) ?
+      det : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  inline double orientation(Point<double> const& o, Point<double> const& p, Point<double> const& q) {
+    double det = __filtered_orientation(o, p, q);
+    if( not std::isnan(det) ) [[likely]] return det;
+    return __exact_orientation(o, p, q);
+  }
+
+  inline double projection(Point<double> const& u, Point<double> const& v, Point<double> const& direction) {
+    constexpr double error_bound = (3 + 16 * __epsilon) * __epsilon;
+    double along_x = (v.x - u.x) * direction.x, along_y = (v.y - u.y) * direction.y;
+    double det = along_x + along_y;
+    if( std::abs(det) > error_bound * (std::abs(along_x) + std::abs(along_y)) ) [[likely]] return det;
+    return __exact_projection(u, v, direction);
+  }
+
+  /* Every term goes through at most seven roundings. */
+  inline double split_order(LineSegment<double> const& left, LineSegment<double> const& right, double split) {
+    constexpr double error_bound = (8 + 64 * __epsilon) * __epsilon;
+    double dlx = left.v.x - left.u.x, dly = left.v.y - left.u.y;
+    double drx = right.u.x - right.v.x, dry = right.u.y - right.v.y;
+    double tlx = split - left.u.x, trx = split - right.v.x;
+    // rounding keeps the sign of a difference, so this test is exact
+    bool flip = not ((dlx > 0 and drx > 0) or (dlx < 0 and drx < 0));
+
+    double l1 = dlx * left.u.y, l2 = tlx * dly, r1 = drx * right.v.y, r2 = trx * dry;
+    double order = drx * (l1 + l2) - dlx * (r1 + r2);
+    double magnitude = std::abs(drx) * (std::abs(l1) + std::abs(l2)) +
+      std::abs(dlx) * (std::abs(r1) + std::abs(r2));
+    if( not (std::abs(order) > error_bound * magnitude) ) [[unlikely]]
+      order = __exact_split_order(left, right, split);
+    return flip ? -order : order;
+  }
+
+}; // end namespace dpch
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dpch {
+
+  /* Treap priorities, drawn from a splitmix64 sequence owned by each structure rather
+   * than from a shared engine, so that independent structures never race and equal
+   * seeds give equal tree shapes. Priorities are nonnegative 31 bit integers. */
+  class Priorities {
+    public:
+      static constexpr uint64_t default_seed = 0x853c49e6748fea9bULL;
+
+      explicit Priorities(uint64_t _seed = default_seed) : state(_seed) { }
+
+      void seed(uint64_t _seed) { state = _seed; }
+
+      inline int32_t operator()() { return mix(state += step); }
+
+      /* The priority ahead draws from now without drawing it, so that threads can take
+       * their share of the next priorities in any order; skip then draws them all. */
+      inline int32_t peek(uint64_t ahead) const { return mix(state + (ahead + 1) * step); }
+      void skip(uint64_t count) { state += count * step; }
+
+    private:
+      static constexpr uint64_t step = 0x9e3779b97f4a7c15ULL;
+      uint64_t state;
+
+      static inline int32_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return int32_t((z ^ (z >> 31)) >> 33);
+      }
+  };
+
+}; // end namespace dpch
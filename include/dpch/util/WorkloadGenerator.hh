@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "Point.hh"
+
+namespace dpch {
+
+  /* Workloads as lazy streams of updates. Point i of a distribution is a pure function
+   * of the seed and of i, drawn from a generator keyed by both, so that a stream keeps a
+   * few counters however long it runs and a deletion recomputes the point it removes
+   * from the index of its insertion. Distributions may repeat points, Duplicates on
+   * purpose; each insertion is deleted at most once. */
+
+  /* splitmix64 keyed by a seed and a counter. */
+  class WorkloadRandom {
+    public:
+      WorkloadRandom(uint64_t seed, uint64_t counter) : state(mix(seed ^ mix(counter + 0x632be59bd9b4e019ULL))) { }
+
+      static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+      }
+
+      uint64_t operator()() { return mix(state += 0x9e3779b97f4a7c15ULL); }
+
+      /* In [0, 1). */
+      double uniform() { return double(operator()() >> 11) * 0x1p-53; }
+      /* In [lo, hi], with a bias below 2^-32 for ranges under 2^32. */
+      int64_t uniform(int64_t lo, int64_t hi) { return lo + int64_t(operator()() % (uint64_t(hi - lo) + 1)); }
+      /* Standard normal, by Box-Muller. */
+      double normal() { return std::sqrt(-2 * std::log(1 - uniform())) * std::cos(2 * M_PI * uniform()); }
+
+    private:
+      uint64_t state;
+  };
+
+  /* Distributions: point(index, random), random keyed by the seed of the stream and index. */
+
+  /* The square [0, range]^2. */
+  template<typename Integer> struct UniformSquare {
+    Integer range = 1000000;
+    Point<Integer> operator()(uint64_t, WorkloadRandom& random) const
+    { return Point<Integer>(random.uniform(0, range), random.uniform(0, range)); }
+  };
+
+  /* y = x^2 for x in [-range, range]: every point is a vertex of the hull. The range
+   * is clamped so that x^2 fits in Integer, to 46340 for int32_t. */
+  template<typename Integer> struct Parabola {
+    Integer range = 1000000;
+    Point<Integer> operator()(uint64_t, WorkloadRandom& random) const {
+      int64_t bound = std::min< int64_t >(range, std::sqrt(double(std::numeric_limits<Integer>::max())));
+      int64_t x = random.uniform(-bound, bound);
+      return Point<Integer>(Integer(x), Integer(x * x));
+    }
+  };
+
+  /* A circle, up to rounding. */
+  template<typename Integer> struct Circle {
+    Integer radius = 1000000;
+    Point<Integer> operator()(uint64_t, WorkloadRandom& random) const {
+      double angle = 2 * M_PI * random.uniform();
+      return Point<Integer>(std::llround(radius * std::cos(angle)), std::llround(radius * std::sin(angle)));
+    }
+  };
+
+  /* Normal clusters of the given deviation around centers uniform in [0, range]^2. */
+  template<typename Integer> struct GaussianClusters {
+    uint64_t clusters = 16;
+    Integer range = 1000000;
+    double deviation = 1000;
+    uint64_t seed = 0;
+    Point<Integer> operator()(uint64_t, WorkloadRandom& random) const {
+      WorkloadRandom center(seed, random.uniform(0, clusters - 1));
+      double x = double(center.uniform(0, range)) + deviation * random.normal();
+      double y = double(center.uniform(0, range)) + deviation * random.normal();
+      return Point<Integer>(std::llround(x), std::llround(y));
+    }
+  };
+
+  /* Draws from a pool of distinct points uniform in [0, range]^2. */
+  template<typename Integer> struct Duplicates {
+    uint64_t distinct = 64;
+    Integer range = 1000000;
+    uint64_t seed = 0;
+    Point<Integer> operator()(uint64_t, WorkloadRandom& random) const {
+      WorkloadRandom pool(seed, random.uniform(0, distinct - 1));
+      return UniformSquare<Integer>{range}(0, pool);
+    }
+  };
+
+  /* Runs of run_length consecutive points within jitter of a random segment in [0, range]^2. */
+  template<typename Integer> struct NearCollinear {
+    uint64_t run_length = 1000;
+    Integer range = 1000000;
+    Integer jitter = 1;
+    uint64_t seed = 0;
+    Point<Integer> operator()(uint64_t index, WorkloadRandom& random) const {
+      WorkloadRandom line(seed, index / run_length);
+      double ux = double(line.uniform(0, range)), uy = double(line.uniform(0, range));
+      double vx = double(line.uniform(0, range)), vy = double(line.uniform(0, range));
+      double t = random.uniform();
+      return Point<Integer>(std::llround(ux + t * (vx - ux)) + random.uniform(-jitter, jitter),
+          std::llround(uy + t * (vy - uy)) + random.uniform(-jitter, jitter));
+    }
+  };
+
+  /* Another distribution, moved by velocity per index: a window drifting across the plane. */
+  template<typename Integer, typename Base = UniformSquare<Integer>> struct Drifting {
+    Base base;
+    double vx = 1, vy = 0;
+    Point<Integer> operator()(uint64_t index, WorkloadRandom& random) const {
+      auto point = base(index, random);
+      return Point<Integer>(point.x + std::llround(vx * double(index)), point.y + std::llround(vy * double(index)));
+    }
+  };
+
+  template<typename Integer> struct Operation {
+    enum Kind : uint8_t { insert, remove };
+    Kind kind;
+    Point<Integer> point;
+  };
+
+  /* n_ops updates: insertions of the points of the distribution in order, and with
+   * probability delete_fraction deletions of earlier insertions, as long as more than
+   * lag + block_size of them are live. Deletions go through the insertions in blocks
+   * of block_size, oldest first, in a random order within each block. The live points
+   * are thus about the last lag insertions: a small lag deletes points soon after
+   * their insertion, and over a Drifting distribution close to the newest ones. */
+  template<typename Integer, typename Distribution> class Workload {
+    public:
+      class iterator;
+
+      Workload(Distribution _distribution, uint64_t _n_ops, uint64_t _seed = 42,
+          double _delete_fraction = 0, uint64_t _lag = 0, uint64_t _block_size = 1)
+        : distribution(_distribution), n_ops(_n_ops), seed(_seed), delete_fraction(_delete_fraction),
+          lag(_lag), block_size(std::max< uint64_t >(1, _block_size)) { }
+
+      /* The next update, or false at the end of the stream. */
+      bool next(Operation<Integer>& operation) {
+        if( produced == n_ops ) return false;
+        WorkloadRandom coin(~seed, produced++);
+        if( delete_fraction > 0 and deleted + lag + block_size <= inserted and coin.uniform() < delete_fraction )
+          operation = {Operation<Integer>::remove, point(victim(deleted++))};
+        else
+          operation = {Operation<Integer>::insert, point(inserted++)};
+        return true;
+      }
+
+      /* Restarts the stream from its first update. */
+      void rewind() { produced = inserted = deleted = 0; }
+
+      Point<Integer> point(uint64_t index) const {
+        WorkloadRandom random(seed, index);
+        return distribution(index, random);
+      }
+
+      /* The first n points of the distribution. */
+      std::vector< Point<Integer> > take(uint64_t n) const {
+        std::vector< Point<Integer> > points(n);
+        for(uint64_t i = 0; i < n; i++) points[i] = point(i);
+        return points;
+      }
+
+      uint64_t get_num_ops() const { return n_ops; }
+      uint64_t get_num_live() const { return inserted - deleted; }
+
+      iterator begin() { rewind(); return iterator(this); }
+      std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    private:
+      Distribution distribution;
+      uint64_t n_ops, seed;
+      double delete_fraction;
+      uint64_t lag, block_size;
+      uint64_t produced = 0, inserted = 0, deleted = 0;
+
+      /* The insertion deleted d-th: an affine permutation of d within its block. */
+      uint64_t victim(uint64_t d) const {
+        uint64_t block = d / block_size, offset = d % block_size;
+        WorkloadRandom random(seed + 1, block);
+        uint64_t multiplier = random() % block_size | 1, shift = random() % block_size;
+        while( std::gcd(multiplier, block_size) != 1 ) multiplier++;
+        return block * block_size + (unsigned __int128)(multiplier * (unsigned __int128)offset + shift) % block_size;
+      }
+  };
+
+  template<typename Integer, typename Distribution> class Workload<Integer, Distribution>::iterator {
+    public:
+      using value_type = Operation<Integer>;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() = default;
+      explicit iterator(Workload* _workload) : workload(_workload) { ++*this; }
+
+      Operation<Integer> const& operator*() const { return operation; }
+      Operation<Integer> const* operator->() const { return &operation; }
+      iterator& operator++() { valid = workload->next(operation); return *this; }
+      void operator++(int) { ++*this; }
+      friend bool operator==(iterator const& it, std::default_sentinel_t) { return not it.valid; }
+
+    private:
+      Workload* workload = nullptr;
+      Operation<Integer> operation{};
+      bool valid = false;
+  };
+
+}; // end namespace dpch
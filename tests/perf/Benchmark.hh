@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* The harness of the perf tests. Each benchmark runs an operation n times per
+ * repetition after a few warmup repetitions, with an untimed setup before each,
+ * against a steady clock less the cost of reading it. Throughput passes time ops in
+ * batches, so that neither the clock nor output weighs on fast operations, and give
+ * the mean and ops per second. Latency passes then time every op on its own, so that
+ * the percentiles and the max are those of single ops, spikes included. Results go
+ * to stdout as text, JSON or CSV at the end, and a CSV from an earlier run can be
+ * compared against, or two of them diffed. */
+namespace bench {
+
+  struct Options {
+    long n_points;
+    int warmup = 1, repetitions = 5;
+    size_t batch = 16;   // ops per timed batch of the throughput passes
+    bool latency = true; // whether to run the latency passes
+    std::string format = "text";
+    std::vector< std::string > compare;
+    double threshold = 5; // percent of mean latency
+  };
+
+  struct Result {
+    std::string name;
+    size_t ops = 0;
+    int repetitions = 0;
+    size_t batch = 0;
+    double mean = 0;                                      // nanoseconds per op, batched
+    double p50 = 0, p99 = 0, p999 = 0, max = 0;           // nanoseconds of single ops
+    double throughput = 0;                                // ops per second
+  };
+
+  /* Keeps the compiler from dropping the computation of a value nobody reads. */
+  template<typename T> inline void keep(T const& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+  inline std::vector< Result > read_csv(std::string const& path) {
+    std::ifstream in(path);
+    if( not in ) { std::cerr << "cannot read " << path << std::endl; std::exit(2); }
+    std::vector< Result > results;
+    std::string line;
+    std::getline(in, line); // header
+    while( std::getline(in, line) ) {
+      std::stringstream fields(line);
+      Result result;
+      std::string field;
+      std::getline(fields, result.name, ',');
+      std::getline(fields, field, ','), result.ops = std::stoul(field);
+      std::getline(fields, field, ','), result.repetitions = std::stoi(field);
+      std::getline(fields, field, ','), result.batch = std::stoul(field);
+      for(double* value: { &result.mean, &result.p50, &result.p99, &result.p999, &result.max, &result.throughput })
+        std::getline(fields, field, ','), *value = std::stod(field);
+      results.push_back(result);
+    }
+    return results;
+  }
+
+  inline void write(std::ostream& out, std::vector< Result > const& results, std::string const& format) {
+    if( format == "csv" ) {
+      out << "benchmark,ops,repetitions,batch,mean_ns,p50_ns,p99_ns,p999_ns,max_ns,ops_per_s\n";
+      for(auto const& r: results)
+        out << r.name << ',' << r.ops << ',' << r.repetitions << ',' << r.batch << ',' << r.mean << ','
+          << r.p50 << ',' << r.p99 << ',' << r.p999 << ',' << r.max << ',' << r.throughput << '\n';
+    } else if( format == "json" ) {
+      out << "{\"benchmarks\": [";
+      for(size_t i = 0; i < results.size(); i++) {
+        auto const& r = results[i];
+        out << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << r.name << "\", \"ops\": " << r.ops
+          << ", \"repetitions\": " << r.repetitions << ", \"batch\": " << r.batch
+          << ", \"mean_ns\": " << r.mean << ", \"p50_ns\": " << r.p50 << ", \"p99_ns\": " << r.p99
+          << ", \"p999_ns\": " << r.p999 << ", \"max_ns\": " << r.max << ", \"ops_per_s\": " << r.throughput << "}";
+      }
+      out << "\n]}\n";
+    } else {
+      out << std::left << std::setw(40) << "benchmark" << std::right << std::setw(10) << "ops"
+        << std::setw(12) << "mean ns" << std::setw(12) << "p50" << std::setw(12) << "p99"
+        << std::setw(12) << "p999" << std::setw(12) << "max" << std::setw(14) << "ops/s" << '\n';
+      for(auto const& r: results)
+        out << std::left << std::setw(40) << r.name << std::right << std::setw(10) << r.ops << std::fixed
+          << std::setprecision(1) << std::setw(12) << r.mean << std::setw(12) << r.p50 << std::setw(12) << r.p99
+          << std::setw(12) << r.p999 << std::setw(12) << r.max << std::setprecision(0) << std::setw(14)
+          << r.throughput << '\n' << std::defaultfloat << std::setprecision(6);
+    }
+  }
+
+  /* Benchmarks of both runs side by side; returns 1 if the mean latency of any
+   * grew by more than the threshold. */
+  inline int compare(std::vector< Result > const& before, std::vector< Result > const& after, double threshold) {
+    std::map< std::string, Result > baseline;
+    for(auto const& r: before) baseline[r.name] = r;
+    int status = 0;
+    std::cout << std::left << std::setw(40) << "benchmark" << std::right << std::setw(12) << "mean before"
+      << std::setw(12) << "after" << std::setw(9) << "delta" << std::setw(12) << "p99 before"
+      << std::setw(12) << "after" << std::setw(9) << "delta" << '\n' << std::fixed << std::setprecision(1);
+    for(auto const& r: after) {
+      auto old = baseline.find(r.name);
+      if( old == baseline.end() ) continue;
+      auto delta = [](double from, double to) { return from > 0 ? 100 * (to - from) / from : 0.0; };
+      bool regressed = delta(old->second.mean, r.mean) > threshold;
+      status |= regressed;
+      std::cout << std::left << std::setw(40) << r.name << std::right
+        << std::setw(12) << old->second.mean << std::setw(12) << r.mean << std::setw(8) << delta(old->second.mean, r.mean) << '%'
+        << std::setw(12) << old->second.p99 << std::setw(12) << r.p99 << std::setw(8) << delta(old->second.p99, r.p99) << '%'
+        << (regressed ? "  regression" : "") << '\n';
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return status;
+  }
+
+  /* [n_points] [--warmup n] [--repetitions n] [--batch n] [--no-latency]
+   * [--format text|json|csv] [--threshold percent] [--compare before.csv [after.csv]].
+   * With two files to compare, diffs them and exits without running anything. */
+  inline Options parse(int argc, char* argv[], long default_points) {
+    Options options{default_points, 1, 5, 16, true, "text", {}, 5};
+    bool has_points = false;
+    for(int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if( arg == "--warmup" and has_value ) options.warmup = std::atoi(argv[++i]);
+      else if( arg == "--repetitions" and has_value ) options.repetitions = std::max(1, std::atoi(argv[++i]));
+      else if( arg == "--batch" and has_value ) options.batch = std::max(1, std::atoi(argv[++i]));
+      else if( arg == "--no-latency" ) options.latency = false;
+      else if( arg == "--format" and has_value ) options.format = argv[++i];
+      else if( arg == "--threshold" and has_value ) options.threshold = std::atof(argv[++i]);
+      else if( arg == "--compare" and has_value ) {
+        options.compare.push_back(argv[++i]);
+        if( i + 1 < argc and std::strncmp(argv[i + 1], "--", 2) != 0 ) options.compare.push_back(argv[++i]);
+      } else if( arg[0] != '-' ) options.n_points = std::atol(argv[i]), has_points = true;
+      else { std::cerr << "unknown option " << arg << std::endl; std::exit(2); }
+    }
+    if( options.compare.size() == 2 )
+      std::exit(compare(read_csv(options.compare[0]), read_csv(options.compare[1]), options.threshold));
+    if( not has_points ) std::cerr << "No size provided: going with " << default_points << " points." << std::endl;
+    return options;
+  }
+
+  class Runner {
+    public:
+      using clock = std::chrono::steady_clock;
+
+      explicit Runner(Options const& _options) : options(_options) {
+        // the cheapest of many back to back clock reads
+        overhead = 1e9;
+        for(int i = 0; i < 1000; i++) {
+          auto tick = clock::now(), tock = clock::now();
+          overhead = std::min(overhead, double(std::chrono::duration_cast<std::chrono::nanoseconds>(tock - tick).count()));
+        }
+      }
+
+      /* op(i) for i in [0, n_ops) per repetition, after setup(). Without latency
+       * passes, the percentiles are left at zero. */
+      template<typename Setup, typename Op>
+        void run(std::string const& name, size_t n_ops, Setup const& setup, Op const& op) {
+          if( n_ops == 0 ) return;
+          double total = 0;
+          for(int repetition = -options.warmup; repetition < options.repetitions; repetition++) {
+            setup();
+            for(size_t first = 0; first < n_ops; first += options.batch) {
+              size_t last = std::min(n_ops, first + options.batch);
+              double elapsed = time([&] { for(size_t i = first; i < last; i++) op(i); });
+              if( repetition >= 0 ) total += elapsed;
+            }
+          }
+
+          Result result{name, n_ops, options.repetitions, options.batch};
+          result.mean = total / double(n_ops * options.repetitions);
+          result.throughput = total > 0 ? 1e9 * double(n_ops * options.repetitions) / total : 0;
+
+          if( options.latency ) {
+            std::vector< double > samples;
+            samples.reserve(options.repetitions * n_ops);
+            for(int repetition = 0; repetition < options.repetitions; repetition++) {
+              setup();
+              for(size_t i = 0; i < n_ops; i++) samples.push_back(time([&] { op(i); }));
+            }
+            std::sort(samples.begin(), samples.end());
+            auto percentile = [&](double q) { return samples[std::min(samples.size() - 1, size_t(q * samples.size()))]; };
+            result.p50 = percentile(0.5), result.p99 = percentile(0.99), result.p999 = percentile(0.999);
+            result.max = samples.back();
+          }
+          results.push_back(result);
+          std::cerr << name << ": " << result.mean << "ns per op" << std::endl;
+        }
+
+      template<typename Op> void run(std::string const& name, size_t n_ops, Op const& op) { run(name, n_ops, [] { }, op); }
+
+      /* Prints the results and compares them to the baseline; the exit status of the test. */
+      int finish() const {
+        write(std::cout, results, options.format);
+        if( options.compare.empty() ) return 0;
+        return compare(read_csv(options.compare[0]), results, options.threshold);
+      }
+
+      Options const& get_options() const { return options; }
+
+    private:
+      Options options;
+      double overhead;
+
+      /* Nanoseconds spent in f, less the cost of reading the clock. */
+      template<typename F> double time(F const& f) const {
+        auto tick = clock::now();
+        f();
+        auto tock = clock::now();
+        return std::max(0.0, double(std::chrono::duration_cast<std::chrono::nanoseconds>(tock - tick).count()) - overhead);
+      }
+
+      std::vector< Result > results;
+  };
+
+}; // end namespace bench
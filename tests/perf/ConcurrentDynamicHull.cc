@@ -0,0 +1,138 @@
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/ConcurrentDynamicHull.hh>
+
+#include "Benchmark.hh"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace dpch;
+
+/* Readers looping over queries on their own threads until stopped, counting them. */
+template<typename Field> class Readers {
+  public:
+    Readers(ConcurrentDynamicHull< Field > const& hull, unsigned n_readers) {
+      for(unsigned i = 0; i < n_readers; i++) threads.emplace_back([&, i] {
+          std::default_random_engine random_engine(i);
+          std::uniform_int_distribution< Field > coordinate(0, 1000000);
+          auto reader = hull.reader();
+          int64_t count = 0;
+          while( not done.load(std::memory_order_relaxed) ) {
+            Point<Field> point(coordinate(random_engine), coordinate(random_engine));
+            bench::keep(reader.point_in_polygon(point)), bench::keep(reader.get_tangents(point));
+            count += 2;
+          }
+          queries += count;
+          });
+    }
+
+    /* Stops the readers; the number of queries they made. */
+    int64_t stop() {
+      done = true;
+      for(auto& thread: threads) thread.join();
+      threads.clear();
+      return queries.load();
+    }
+
+    ~Readers() { stop(); }
+
+  private:
+    std::atomic<bool> done = false;
+    std::atomic<int64_t> queries = 0;
+    std::vector< std::thread > threads;
+};
+
+/* Writer latency against the bare DynamicHull, alone and with increasing numbers of
+ * reader threads alongside, then every query of a reader, alone and alongside a writer. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  runner.run("concurrent/dynamic_add_point/" + input, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(); },
+      [&](size_t i) { dynamic_hull->add_point(points[i]); });
+  runner.run("concurrent/dynamic_remove_point/" + input, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(points.begin(), points.end()); },
+      [&](size_t i) { dynamic_hull->remove_point(points[i]); });
+  dynamic_hull.reset();
+
+  std::unique_ptr< ConcurrentDynamicHull< Field > > concurrent_hull;
+  auto empty = [&] { concurrent_hull = std::make_unique< ConcurrentDynamicHull< Field > >(); };
+  auto full = [&] {
+    empty();
+    concurrent_hull->apply_batch(std::span< Point<Field> const >(points), {});
+  };
+  runner.run("concurrent/add_point/" + input, points.size(), empty,
+      [&](size_t i) { concurrent_hull->add_point(points[i]); });
+  runner.run("concurrent/remove_point/" + input, points.size(), full,
+      [&](size_t i) { bench::keep(concurrent_hull->remove_point(points[i])); });
+  for(size_t batch_size: { 16, 1024 }) {
+    runner.run("concurrent/apply_batch/" + std::to_string(batch_size) + "/" + input, points.size() / batch_size, empty,
+        [&](size_t i) {
+          bench::keep(concurrent_hull->apply_batch(
+                std::span< Point<Field> const >(points).subspan(i * batch_size, batch_size), {}));
+        });
+  }
+
+  // updates alternate removals and insertions so that every repetition starts from the full hull
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for(unsigned n_readers = 1; n_readers <= max_threads; n_readers *= 2) {
+    full();
+    Readers< Field > readers(*concurrent_hull, n_readers);
+    auto tick = std::chrono::steady_clock::now();
+    runner.run("concurrent/update/" + std::to_string(n_readers) + "_readers/" + input, 2 * points.size(), [&](size_t i) {
+      if( i < points.size() ) concurrent_hull->remove_point(points[i]);
+      else concurrent_hull->add_point(points[i - points.size()]);
+    });
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tick).count();
+    std::cerr << n_readers << " readers: " << readers.stop() * 1000 / std::max< int64_t >(1, elapsed)
+      << " queries per us" << std::endl;
+  }
+
+  full();
+  auto queries = random_int_test<Field>(points.size()), directions = queries;
+  for(auto& direction: directions) direction = direction - Point<Field>(500000, 500000);
+  auto reader = concurrent_hull->reader();
+  auto run_queries = [&](std::string const& suffix) {
+    runner.run("concurrent/reader_point_in_polygon/" + suffix, queries.size(),
+        [&](size_t i) { bench::keep(reader.point_in_polygon(queries[i])); });
+    runner.run("concurrent/reader_get_tangents/" + suffix, queries.size(),
+        [&](size_t i) { bench::keep(reader.get_tangents(queries[i])); });
+    runner.run("concurrent/reader_get_extremal_points/" + suffix, directions.size(),
+        [&](size_t i) { bench::keep(reader.get_extremal_points(directions[i])); });
+    runner.run("concurrent/reader_get_hull_size/" + suffix, queries.size(),
+        [&](size_t) { bench::keep(reader.get_hull_size()); });
+    runner.run("concurrent/reader_freeze/" + suffix, 1,
+        [&](size_t) { bench::keep(reader.freeze().get_hull_size()); });
+  };
+  run_queries(input);
+
+  // the writer keeps the hull between a quarter of the points and all of them
+  std::atomic<bool> done = false;
+  std::thread writer([&] {
+      size_t quarter = points.size() / 4;
+      while( not done.load(std::memory_order_relaxed) ) {
+        for(size_t i = quarter; i < points.size(); i++) concurrent_hull->remove_point(points[i]);
+        for(size_t i = quarter; i < points.size(); i++) concurrent_hull->add_point(points[i]);
+      }
+      });
+  run_queries("with_writer/" + input);
+  done = true;
+  writer.join();
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 100000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  test_perf(runner, "random", random_int_test<int64_t>(n_points));
+  test_perf(runner, "circle", random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+
+  return runner.finish();
+}
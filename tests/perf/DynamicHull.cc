@@ -1,64 +1,221 @@
 #include <dpch/util/TestGenerator.hh>
+#include <dpch/util/WorkloadGenerator.hh>
 #include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/FrozenHull.hh>
 
+#include "Benchmark.hh"
+
+#include <cmath>
 #include <iostream>
-#include <iomanip>
+#include <memory>
 #include <vector>
-#include <chrono>
-#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <span>
+#include <random>
+#include <algorithm>
 
 using namespace dpch;
 
-template<typename Field> void test_perf( std::vector< Point<Field> > points ) {
-
-  auto iter = points.begin();
+/* Single insertions into an empty hull, then single removals in random order. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > points ) {
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  runner.run("dynamic/add_point/" + input, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(); },
+      [&](size_t i) { dynamic_hull->add_point(points[i]); });
+  std::unique_ptr< DynamicHull< Field, ChainSummary<Field> > > measured_hull;
+  runner.run("dynamic/add_point_and_measure/" + input, points.size(),
+      [&] { measured_hull = std::make_unique< DynamicHull< Field, ChainSummary<Field> > >(); },
+      [&](size_t i) {
+        measured_hull->add_point(points[i]);
+        bench::keep(measured_hull->area() + measured_hull->perimeter() + measured_hull->centroid().x);
+      });
+  measured_hull.reset();
 
-  DynamicHull< Field > dynamic_hull;
+  std::vector< Point<Field> > order(points);
+  std::shuffle(order.begin(), order.end(), std::default_random_engine());
+  runner.run("dynamic/remove_point/" + input, order.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(points.begin(), points.end()); },
+      [&](size_t i) { dynamic_hull->remove_point(order[i]); });
+}
 
-  while( iter != points.end() ) {
-    auto const&point = *iter++;
-    /* Get hull sizes. */
-    auto num_points = dynamic_hull.get_num_points();
-    /* Check time. */
-    auto tick = std::chrono::high_resolution_clock::now();
-    dynamic_hull.add_point(point);
-    auto tock = std::chrono::high_resolution_clock::now();
-    auto runtime = std::chrono::duration_cast
-      <std::chrono::nanoseconds>(tock - tick).count();
-    std::cout << num_points << ':' << runtime << '\n';
-  };
+/* Bulk construction, and the scaling of the parallel build with the number of threads. */
+template<typename Field> void test_build( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    runner.run("dynamic/build/" + std::to_string(threads) + "_threads/" + input, 1, [&](size_t) {
+      DynamicHull< Field > dynamic_hull(points.begin(), points.end(), false, threads);
+      bench::keep(dynamic_hull.get_hull_size());
+    });
+}
 
+/* Deleting a batch of points one at a time against a single apply_batch. */
+template<typename Field> void test_batch( bench::Runner& runner, std::vector< Point<Field> > points, size_t batch_size ) {
   std::default_random_engine random_engine;
   std::shuffle(std::begin(points), std::end(points), random_engine);
+  batch_size = std::min(batch_size, points.size());
+  std::span< Point<Field> const > deletes(points.data(), batch_size);
+  std::string suffix = std::to_string(batch_size) + "_of_" + std::to_string(points.size());
 
-  iter = points.begin();
-  while( iter != points.end() ) {
-    auto const&point = *iter++;
-    /* Get hull sizes. */
-    auto num_points = dynamic_hull.get_num_points();
-    /* Check time. */
-    auto tick = std::chrono::high_resolution_clock::now();
-    dynamic_hull.remove_point(point);
-    auto tock = std::chrono::high_resolution_clock::now();
-    auto runtime = std::chrono::duration_cast
-      <std::chrono::nanoseconds>(tock - tick).count();
-    std::cout << num_points << ':' << runtime << '\n';
-  };
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  auto setup = [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(points.begin(), points.end()); };
+  runner.run("dynamic/delete_each/" + suffix, 1, setup,
+      [&](size_t) { for(auto const& point: deletes) dynamic_hull->remove_point(point); });
+  runner.run("dynamic/apply_batch/" + suffix, 1, setup,
+      [&](size_t) { dynamic_hull->apply_batch({}, deletes); });
 }
 
-int main(int argc, char* argv[]) {
-  int n_points;
-  if( argc != 2 ) {
-    std::cerr << "No argument provided; going with 10k point additions followed by removal." << std::endl;
-    n_points = 10000;
-  } else {
-    n_points = std::atoi(argv[1]);
+/* What-if queries: fork, remove a few points, query and discard, against rebuilding. */
+template<typename Field> void test_fork( bench::Runner& runner, std::vector< Point<Field> > points, size_t n_removals ) {
+  std::default_random_engine random_engine;
+  DynamicHull< Field > dynamic_hull(points.begin(), points.end());
+
+  std::uniform_int_distribution< size_t > random_index(0, points.size() - 1);
+  std::vector< Point<Field> > removals(16 * n_removals);
+  for(auto& point: removals) point = points[random_index(random_engine)];
+
+  runner.run("dynamic/fork_and_remove/" + std::to_string(n_removals), 16, [&](size_t round) {
+    auto fork = dynamic_hull.fork();
+    for(size_t i = 0; i < n_removals; i++) fork.remove_point(removals[round * n_removals + i]);
+    bench::keep(fork.get_hull_size());
+  });
+  runner.run("dynamic/rebuild_without/" + std::to_string(n_removals), 1, [&](size_t) {
+    DynamicHull< Field > copy(points.begin() + n_removals, points.end());
+    bench::keep(copy.get_hull_size());
+  });
+}
+
+/* Independent hulls, one per task, built on a growing number of threads. */
+template<typename Field> void test_independent( bench::Runner& runner, std::vector< Point<Field> > const& points, size_t n_hulls ) {
+  size_t share = points.size() / n_hulls;
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    runner.run("dynamic/independent/" + std::to_string(n_hulls) + "_hulls/" + std::to_string(threads) + "_threads", 1,
+        [&](size_t) {
+          std::atomic< size_t > next_hull = 0, hull_size = 0;
+          std::vector< std::thread > workers;
+          for(unsigned t = 0; t < threads; t++) workers.emplace_back([&] {
+            for(size_t hull; (hull = next_hull++) < n_hulls; ) {
+              DynamicHull< Field > dynamic_hull;
+              dynamic_hull.seed(hull);
+              for(size_t i = hull * share; i < (hull + 1) * share; i++) dynamic_hull.add_point(points[i]);
+              hull_size += dynamic_hull.get_hull_size();
+            }
+          });
+          for(auto& worker: workers) worker.join();
+          bench::keep(hull_size);
+        });
+}
+
+/* The same points stored in 32 and in 64 bits. */
+template<typename Narrow, typename Wide> void test_storage( bench::Runner& runner, std::vector< Point<Wide> > const& points ) {
+  std::vector< Point<Narrow> > narrow_points;
+  for(auto const& point: points) narrow_points.emplace_back(Narrow(point.x), Narrow(point.y));
+
+  runner.run("dynamic/build/" + std::to_string(sizeof(LineSegment<Narrow>)) + "_byte_segments", 1, [&](size_t) {
+    DynamicHull< Narrow > dynamic_hull(narrow_points.begin(), narrow_points.end());
+    bench::keep(dynamic_hull.get_hull_size());
+  });
+  runner.run("dynamic/build/" + std::to_string(sizeof(LineSegment<Wide>)) + "_byte_segments", 1, [&](size_t) {
+    DynamicHull< Wide > dynamic_hull(points.begin(), points.end());
+    bench::keep(dynamic_hull.get_hull_size());
+  });
+}
+
+/* Queries against the hull of every point, at points spread over its bounding box. */
+template<typename Field> void test_queries( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  DynamicHull< Field > dynamic_hull(points.begin(), points.end());
+  auto queries = random_int_test<Field>(points.size()), directions = queries;
+  for(auto& direction: directions) direction = direction - Point<Field>(500000, 500000);
+  auto left = dynamic_hull.get_extremal_points(Point<Field>(-1, 0)).first, right = dynamic_hull.get_extremal_points(Point<Field>(1, 0)).first;
+  auto bottom = dynamic_hull.get_extremal_points(Point<Field>(0, -1)).first, top = dynamic_hull.get_extremal_points(Point<Field>(0, 1)).first;
+  for(auto& query: queries) {
+    query.x = left.x + (right.x - left.x) * (query.x / 1e6);
+    query.y = bottom.y + (top.y - bottom.y) * (query.y / 1e6);
+  }
+
+  runner.run("dynamic/point_in_polygon/" + input, queries.size(),
+      [&](size_t i) { bench::keep(dynamic_hull.point_in_polygon(queries[i])); });
+  runner.run("dynamic/get_tangents/" + input, queries.size(),
+      [&](size_t i) { bench::keep(dynamic_hull.get_tangents(queries[i])); });
+  runner.run("dynamic/get_extremal_points/" + input, queries.size(),
+      [&](size_t i) { bench::keep(dynamic_hull.get_extremal_points(directions[i])); });
+  size_t batch_size = std::min< size_t >(1024, directions.size());
+  runner.run("dynamic/get_extremal_points_batch/" + std::to_string(batch_size) + "/" + input, directions.size() / batch_size,
+      [&](size_t i) {
+        bench::keep(dynamic_hull.get_extremal_points_batch(
+              std::span< Point<Field> const >(directions).subspan(i * batch_size, batch_size)).size());
+      });
+  runner.run("dynamic/get_extremal_points_batch/all/" + input, 1, [&](size_t) {
+    bench::keep(dynamic_hull.get_extremal_points_batch(std::span< Point<Field> const >(directions)).size());
+  });
+
+  // the same queries against a frozen copy, one at a time and in batches
+  FrozenHull< Field > frozen_hull(dynamic_hull);
+  std::span< Point<Field> const > all(queries);
+  runner.run("frozen/point_in_polygon/" + input, queries.size(),
+      [&](size_t i) { bench::keep(frozen_hull.point_in_polygon(queries[i])); });
+  runner.run("frozen/get_tangents/" + input, queries.size(),
+      [&](size_t i) { bench::keep(frozen_hull.get_tangents(queries[i])); });
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for(unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    std::string suffix = std::to_string(threads) + "_threads/" + input;
+    runner.run("frozen/point_in_polygon_batch/" + suffix, 1,
+        [&](size_t) { bench::keep(frozen_hull.point_in_polygon_batch(all, threads).size()); });
+    runner.run("frozen/get_tangents_batch/" + suffix, 1,
+        [&](size_t) { bench::keep(frozen_hull.get_tangents_batch(all, threads).size()); });
   }
+  runner.run("dynamic/traverse_hull/" + input, 1, [&](size_t) {
+    size_t hull_size = 0;
+    dynamic_hull.traverse_lower_hull([&](LineSegment<Field> const&) { hull_size++; });
+    dynamic_hull.traverse_upper_hull([&](LineSegment<Field> const&) { hull_size++; });
+    bench::keep(hull_size);
+  });
+  runner.run("dynamic/traverse_set/" + input, 1, [&](size_t) {
+    size_t num_points = 0;
+    dynamic_hull.traverse_set([&](Point<Field> const&) { num_points++; });
+    bench::keep(num_points);
+  });
+}
+
+/* A streamed workload from an empty hull, one update per op. */
+template<typename Field, typename Distribution> void test_workload( bench::Runner& runner, std::string const& name,
+    Workload<Field, Distribution> workload ) {
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  Operation<Field> operation;
+  runner.run("dynamic/workload/" + name, workload.get_num_ops(),
+      [&] { workload.rewind(), dynamic_hull = std::make_unique< DynamicHull< Field > >(); },
+      [&](size_t) {
+        workload.next(operation);
+        if( operation.kind == Operation<Field>::insert ) dynamic_hull->add_point(operation.point);
+        else dynamic_hull->remove_point(operation.point);
+      });
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 10000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
 
   std::vector< Point<int64_t> > points =
     random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false);
+  auto random_points = random_int_test<int64_t>(n_points);
+
+  test_perf(runner, "circle", points);
+  test_perf(runner, "random", random_points);
+  test_build(runner, "circle", points);
+  test_build(runner, "random", random_points);
+  test_storage< int32_t >(runner, points);
+  test_independent(runner, points, 256);
+  for(size_t batch_size: { 16, 1024, 65536 }) test_batch(runner, points, batch_size);
+  for(size_t n_removals: { 1, 16, 256 }) test_fork(runner, points, n_removals);
+  test_queries(runner, "circle", points);
+  test_queries(runner, "random", random_points);
 
-  test_perf(points);
+  test_workload(runner, "parabola", Workload<int64_t, Parabola<int64_t>>({}, n_points));
+  test_workload(runner, "clusters", Workload<int64_t, GaussianClusters<int64_t>>({}, n_points));
+  test_workload(runner, "near_collinear", Workload<int64_t, NearCollinear<int64_t>>({}, n_points));
+  test_workload(runner, "drifting_window", Workload<int64_t, Drifting<int64_t>>({{100000}, 10, 0}, 4 * n_points, 42, 0.5, 1000, 64));
 
-  return 0;
+  return runner.finish();
 }
@@ -1,59 +1,115 @@
 #include <dpch/util/Point.hh>
-#include <dpch/util/Tangent.hh>
 #include <dpch/util/TestGenerator.hh>
-#include <dpch/static/ConvexHull.hh>
+#include <dpch/util/WorkloadGenerator.hh>
 #include <dpch/online/OnlineHull.hh>
 
+#include "Benchmark.hh"
 
+#include <cmath>
 #include <iostream>
-#include <iomanip>
+#include <memory>
 #include <vector>
-#include <chrono>
-#include <unordered_map>
+#include <span>
 
 using namespace dpch;
 
-template<typename Field> void test_perf( std::vector< Point<Field> > const& points ) {
+/* Every public operation of the online hull, on one input. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input,
+    std::vector< Point<Field> > const& points ) {
   assert( points.size() > 2 );
+  std::unique_ptr< OnlineHull< Field > > dynamic_hull;
+
+  runner.run("online/add_point/" + input, points.size() - 2,
+      [&] { dynamic_hull = std::make_unique< OnlineHull< Field > >(points[0], points[1]); },
+      [&](size_t i) { dynamic_hull->add_point(points[i + 2]); });
+  std::cerr << "interior cache: " << dynamic_hull->get_cache_hits() << " hits out of "
+    << dynamic_hull->get_cache_probes() << " probes" << std::endl;
+  std::unique_ptr< OnlineHull< Field, ChainSummary<Field> > > measured_hull;
+  runner.run("online/add_point_and_measure/" + input, points.size() - 2,
+      [&] { measured_hull = std::make_unique< OnlineHull< Field, ChainSummary<Field> > >(points[0], points[1]); },
+      [&](size_t i) {
+        measured_hull->add_point(points[i + 2]);
+        bench::keep(measured_hull->area() + measured_hull->perimeter() + measured_hull->centroid().x);
+      });
+  measured_hull.reset();
+
+  for(size_t batch_size: {16, 1024, 65536}) {
+    size_t n_batches = (points.size() - 2 + batch_size - 1) / batch_size;
+    runner.run("online/add_points/" + std::to_string(batch_size) + "/" + input, n_batches,
+        [&] { dynamic_hull = std::make_unique< OnlineHull< Field > >(points[0], points[1]); },
+        [&](size_t i) {
+          size_t first = 2 + i * batch_size;
+          dynamic_hull->add_points(std::span< Point<Field> const >(
+                points.begin() + first, points.begin() + std::min(points.size(), first + batch_size)));
+        });
+  }
 
-  auto iter = points.begin();
-
-  auto const&first_point = *iter++;
-  auto const&second_point = *iter++;
-  OnlineHull< Field > dynamic_hull(first_point, second_point);
-
-  while( iter != points.end() ) {
-
-    auto const&point = *iter++;
-
-    /* Get hull sizes. */
-    auto hull_size = dynamic_hull.get_hull_size();
-    /* Check time. */
-    auto tick = std::chrono::high_resolution_clock::now();
-
-    dynamic_hull.add_point(point);
-
-    auto tock = std::chrono::high_resolution_clock::now();
-
-    auto runtime = std::chrono::duration_cast
-      <std::chrono::nanoseconds>(tock - tick).count();
+  runner.run("online/build/" + input, 1, [&](size_t) {
+    OnlineHull< Field > bulk_hull{std::span< Point<Field> const >(points)};
+    bench::keep(bulk_hull.get_hull_size());
+  });
+
+  // queries against the hull of every point, at points spread over its bounding box
+  OnlineHull< Field > full_hull{std::span< Point<Field> const >(points)};
+  auto queries = random_int_test<Field>(points.size()), directions = queries;
+  for(auto& direction: directions) direction = direction - Point<Field>(500000, 500000);
+  auto left = full_hull.get_extremal_points(Point<Field>(-1, 0)).first, right = full_hull.get_extremal_points(Point<Field>(1, 0)).first;
+  auto bottom = full_hull.get_extremal_points(Point<Field>(0, -1)).first, top = full_hull.get_extremal_points(Point<Field>(0, 1)).first;
+  for(auto& query: queries) {
+    query.x = left.x + (right.x - left.x) * (query.x / 1e6);
+    query.y = bottom.y + (top.y - bottom.y) * (query.y / 1e6);
+  }
+  runner.run("online/point_in_polygon/" + input, queries.size(),
+      [&](size_t i) { bench::keep(full_hull.point_in_polygon(queries[i])); });
+  runner.run("online/get_tangents/" + input, queries.size(),
+      [&](size_t i) { bench::keep(full_hull.get_tangents(queries[i])); });
+  runner.run("online/get_extremal_points/" + input, queries.size(),
+      [&](size_t i) { bench::keep(full_hull.get_extremal_points(directions[i])); });
+  size_t batch_size = std::min< size_t >(1024, directions.size());
+  runner.run("online/get_extremal_points_batch/" + std::to_string(batch_size) + "/" + input, directions.size() / batch_size,
+      [&](size_t i) {
+        bench::keep(full_hull.get_extremal_points_batch(
+              std::span< Point<Field> const >(directions).subspan(i * batch_size, batch_size)).size());
+      });
+  runner.run("online/get_extremal_points_batch/all/" + input, 1, [&](size_t) {
+    bench::keep(full_hull.get_extremal_points_batch(std::span< Point<Field> const >(directions)).size());
+  });
+  runner.run("online/traverse_hull/" + input, 1, [&](size_t) {
+    size_t hull_size = 0;
+    full_hull.traverse_hull([&](auto const&...) { hull_size++; });
+    bench::keep(hull_size);
+  });
+}
 
-    std::cout << hull_size << ':' << runtime << '\n';
-  };
+/* Insertions of a streamed workload, one per op, after its first two points. */
+template<typename Field, typename Distribution> void test_workload( bench::Runner& runner, std::string const& name,
+    Workload<Field, Distribution> workload ) {
+  std::unique_ptr< OnlineHull< Field > > dynamic_hull;
+  Operation<Field> operation;
+  runner.run("online/workload/" + name, workload.get_num_ops() - 2,
+      [&] {
+        workload.rewind();
+        Point<Field> first, second;
+        for(workload.next(operation), first = operation.point; workload.next(operation) and operation.point == first; );
+        second = operation.point;
+        dynamic_hull = std::make_unique< OnlineHull< Field > >(first, second);
+      },
+      [&](size_t) { if( workload.next(operation) ) dynamic_hull->add_point(operation.point); });
 }
 
 int main(int argc, char* argv[]) {
-  int n_points;
-  if( argc != 2 ) {
-    std::cerr << "No argument provided: going with 10k point additions." << std::endl;
-    n_points = 10000;
-  } else {
-    n_points = std::atoi(argv[1]);
-  }
+  auto options = bench::parse(argc, argv, 10000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
 
-  std::vector< Point<int64_t> > points = random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false);
+  test_perf(runner, "circle", random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+  test_perf(runner, "random", random_int_test<int64_t>(n_points));
 
-  test_perf(points);
+  test_workload(runner, "parabola", Workload<int64_t, Parabola<int64_t>>({}, n_points));
+  test_workload(runner, "clusters", Workload<int64_t, GaussianClusters<int64_t>>({}, n_points));
+  test_workload(runner, "duplicates", Workload<int64_t, Duplicates<int64_t>>({}, n_points));
+  test_workload(runner, "near_collinear", Workload<int64_t, NearCollinear<int64_t>>({}, n_points));
+  test_workload(runner, "drifting", Workload<int64_t, Drifting<int64_t>>({{100000}, 10, 0}, n_points));
 
-  return 0;
+  return runner.finish();
 }
@@ -0,0 +1,52 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/OutputSensitiveHull.hh>
+
+#include "Benchmark.hh"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace dpch;
+
+/* Monotone chain against Chan's algorithm on the same input. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  auto [lower_chain, upper_chain] = convex_hull(points, false);
+  std::cerr << input << ": " << points.size() << " points, " << lower_chain.size() + upper_chain.size() - 2
+    << " on hull" << std::endl;
+  runner.run("static/convex_hull/" + input, 1, [&](size_t) {
+    auto [lower, upper] = convex_hull(points, false);
+    bench::keep(lower.size() + upper.size());
+  });
+  runner.run("static/output_sensitive_convex_hull/" + input, 1, [&](size_t) {
+    auto [lower, upper] = output_sensitive_convex_hull(points);
+    bench::keep(lower.size() + upper.size());
+  });
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 1000000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  test_perf(runner, "random", random_int_test<int64_t>(n_points));
+
+  /* Points inside a square inscribed in a circle with h points on the circle. */
+  for(int hull_size = 16; hull_size < n_points; hull_size *= 8) {
+    int64_t radius = 1 << 29;
+    auto points = random_circle_int_test<int64_t>(hull_size, radius, false);
+    for(auto point: random_int_test<int64_t>(n_points - hull_size, radius))
+      points.emplace_back(point.x - radius / 2, point.y - radius / 2);
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    std::shuffle(points.begin(), points.end(), std::default_random_engine(42));
+    test_perf(runner, "hull_" + std::to_string(hull_size), points);
+  }
+
+  test_perf(runner, "circle", random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+
+  return runner.finish();
+}
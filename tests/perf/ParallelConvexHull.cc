@@ -0,0 +1,53 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/RadixSort.hh>
+#include <dpch/static/ParallelConvexHull.hh>
+
+#include "Benchmark.hh"
+
+#include <iostream>
+#include <vector>
+#include <span>
+#include <thread>
+
+using namespace dpch;
+
+/* Sequential monotone chain against the parallel hull and its sort at increasing
+ * thread counts, each on a fresh copy of the input. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  std::vector< Point<Field> > polygon;
+  auto copy = [&] { polygon = points; };
+  runner.run("static/convex_hull/" + input, 1, copy, [&](size_t) {
+    auto [lower_chain, upper_chain] = convex_hull(std::span< Point<Field> >(polygon), false);
+    bench::keep(lower_chain.size() + upper_chain.size());
+  });
+
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for(unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    auto suffix = std::to_string(threads) + "_threads/" + input;
+    runner.run("static/parallel_convex_hull/" + suffix, 1, copy, [&](size_t) {
+      auto [lower_chain, upper_chain] = parallel_convex_hull(std::span< Point<Field> >(polygon), threads);
+      bench::keep(lower_chain.size() + upper_chain.size());
+    });
+    runner.run("static/radix_sort/" + suffix, 1, copy, [&](size_t) {
+      ForkJoin pool(threads);
+      radix_sort(std::span< Point<Field> >(polygon), pool);
+    });
+    runner.run("static/parallel_sort/" + suffix, 1, copy, [&](size_t) {
+      ForkJoin pool(threads);
+      parallel_sort(pool, polygon.begin(), polygon.end());
+    });
+  }
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 10000000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  test_perf(runner, "random", random_int_test<int64_t>(n_points));
+  test_perf(runner, "circle", random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+
+  return runner.finish();
+}
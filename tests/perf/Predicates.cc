@@ -0,0 +1,70 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+
+#include "Benchmark.hh"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <random>
+#include <cmath>
+
+using namespace dpch;
+
+/* The predicates over consecutive points, plain doubles against the filtered ones. */
+void test_predicates( bench::Runner& runner, std::string const& input, std::vector< Point<double> > const& points ) {
+  size_t n_triples = points.size() - 3;
+  runner.run("predicates/plain_orientation/" + input, n_triples,
+      [&](size_t i) { bench::keep(cross(points[i+1] - points[i], points[i+2] - points[i])); });
+  runner.run("predicates/orientation/" + input, n_triples,
+      [&](size_t i) { bench::keep(orientation(points[i], points[i+1], points[i+2])); });
+  runner.run("predicates/plain_projection/" + input, n_triples,
+      [&](size_t i) { bench::keep(dot(points[i+1] - points[i], points[i+2])); });
+  runner.run("predicates/projection/" + input, n_triples,
+      [&](size_t i) { bench::keep(projection(points[i], points[i+1], points[i+2])); });
+  runner.run("predicates/split_order/" + input, n_triples, [&](size_t i) {
+    LineSegment<double> left{points[i], points[i+1]}, right{points[i+2], points[i+3]};
+    bench::keep(split_order(left, right, (points[i+1].x + points[i+2].x) / 2));
+  });
+}
+
+/* Incremental construction of a hull over doubles. */
+void test_hull( bench::Runner& runner, std::string const& input, std::vector< Point<double> > const& points ) {
+  std::unique_ptr< DynamicHull< double > > dynamic_hull;
+  runner.run("predicates/add_point/" + input, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< double > >(); },
+      [&](size_t i) { dynamic_hull->add_point(points[i]); });
+  std::cerr << input << ": " << dynamic_hull->get_hull_size() << " segments" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 1000000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  std::default_random_engine random_engine;
+  std::uniform_real_distribution< double > position(0, 1);
+  std::vector< Point<double> > random_points(n_points), collinear_points(n_points);
+  for(auto& point: random_points) point = Point<double>(position(random_engine), position(random_engine));
+  for(auto& point: collinear_points) {
+    double x = position(random_engine);
+    point = Point<double>(x, x / 3);
+  }
+
+  test_predicates(runner, "random", random_points);
+  test_predicates(runner, "collinear", collinear_points);
+  // incremental construction is much slower per point than a single predicate
+  random_points.resize(n_points / 20);
+  test_hull(runner, "random", random_points);
+  std::vector< Point<double> > circle_points;
+  for(int i = 0; i < n_points / 100; i++) {
+    double angle = 2 * acos(-1) * i / (n_points / 100);
+    circle_points.emplace_back(cos(angle), sin(angle));
+  }
+  std::shuffle(circle_points.begin(), circle_points.end(), random_engine);
+  test_hull(runner, "circle", circle_points);
+
+  return runner.finish();
+}
@@ -0,0 +1,50 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/Prefilter.hh>
+
+#include "Benchmark.hh"
+
+#include <iostream>
+#include <vector>
+#include <span>
+#include <algorithm>
+
+using namespace dpch;
+
+/* Cost of the prefilter and of the prefiltered hull against sorting the whole input,
+ * each on a fresh copy of it. */
+template<typename Field> void test_perf( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  std::vector< Point<Field> > polygon = points;
+  std::cerr << input << ": " << points.size() << " points, " << prefilter(std::span< Point<Field> >(polygon))
+    << " kept" << std::endl;
+  auto copy = [&] { polygon = points; };
+  runner.run("static/prefilter/" + input, 1, copy,
+      [&](size_t) { bench::keep(prefilter(std::span< Point<Field> >(polygon))); });
+  runner.run("static/convex_hull/" + input, 1, copy, [&](size_t) {
+    auto [lower_chain, upper_chain] = convex_hull(std::span< Point<Field> >(polygon), false);
+    bench::keep(lower_chain.size() + upper_chain.size());
+  });
+  runner.run("static/sort/" + input, 1, copy, [&](size_t) { std::sort(polygon.begin(), polygon.end()); });
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 10000000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  auto points = random_int_test<int64_t>(n_points);
+  test_perf(runner, "int64", points);
+
+  std::vector< Point<int32_t> > narrow;
+  for(auto point: points) narrow.emplace_back(int32_t(point.x / 64), int32_t(point.y / 64));
+  test_perf(runner, "int32", narrow);
+
+  std::vector< Point<double> > real;
+  for(auto point: points) real.emplace_back(point.x * 1e-3, point.y * 1e-3);
+  test_perf(runner, "double", real);
+
+  test_perf(runner, "circle", random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+
+  return runner.finish();
+}
@@ -0,0 +1,101 @@
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/ShardedDynamicHull.hh>
+
+#include "Benchmark.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace dpch;
+
+/* Every public operation of a sharded hull, with insertions from one writer and from
+ * several, each to a shard's worth of points, against a single DynamicHull. */
+template<typename Field> void test_shards( bench::Runner& runner, std::string const& input,
+    std::vector< Point<Field> > const& points, int32_t n_shards, unsigned n_writers ) {
+  auto suffix = std::to_string(n_shards) + "_shards/" + input;
+  size_t n_queries = points.size() / 10, n_first = points.size() / 16;
+  std::span< Point<Field> const > all(points), first(points.data(), n_first);
+
+  std::unique_ptr< ShardedDynamicHull< Field > > sharded_hull;
+  // a first batch places the boundaries
+  auto placed = [&] {
+    sharded_hull = std::make_unique< ShardedDynamicHull< Field > >(n_shards);
+    sharded_hull->apply_batch(first, {}, n_writers);
+  };
+  auto full = [&] {
+    sharded_hull = std::make_unique< ShardedDynamicHull< Field > >(n_shards);
+    sharded_hull->apply_batch(all, {}, n_writers), sharded_hull->merge(n_writers);
+  };
+
+  runner.run("sharded/add_point/" + suffix, points.size() - n_first, placed,
+      [&](size_t i) { sharded_hull->add_point(points[n_first + i]); });
+  runner.run("sharded/add_point/" + std::to_string(n_writers) + "_writers/" + suffix, 1, placed, [&](size_t) {
+    std::vector< std::thread > writers;
+    for(unsigned t = 0; t < n_writers; t++) writers.emplace_back([&, t] {
+      for(size_t i = n_first + t; i < points.size(); i += n_writers) sharded_hull->add_point(points[i]);
+    });
+    for(auto& writer: writers) writer.join();
+  });
+  runner.run("sharded/merge/" + std::to_string(n_writers) + "_threads/" + suffix, 1,
+      [&] { placed(), sharded_hull->apply_batch(all.subspan(n_first), {}, n_writers); },
+      [&](size_t) { sharded_hull->merge(n_writers); });
+  runner.run("sharded/remove_point/" + suffix, points.size(), full,
+      [&](size_t i) { bench::keep(sharded_hull->remove_point(points[i])); });
+  runner.run("sharded/apply_batch/" + std::to_string(n_writers) + "_threads/" + suffix, 1,
+      [&] { sharded_hull = std::make_unique< ShardedDynamicHull< Field > >(n_shards); },
+      [&](size_t) { bench::keep(sharded_hull->apply_batch(all, {}, n_writers)); });
+  runner.run("sharded/rebalance/" + std::to_string(n_writers) + "_threads/" + suffix, 1,
+      [&] { placed(), sharded_hull->apply_batch(all.subspan(n_first), {}, n_writers); },
+      [&](size_t) { sharded_hull->rebalance(n_writers); });
+
+  full();
+  auto directions = random_int_test<Field>(n_queries);
+  for(auto& direction: directions) direction = direction - Point<Field>(500000, 500000);
+  runner.run("sharded/point_in_polygon/" + suffix, n_queries,
+      [&](size_t i) { bench::keep(sharded_hull->point_in_polygon(points[i])); });
+  runner.run("sharded/get_tangents/" + suffix, n_queries,
+      [&](size_t i) { bench::keep(sharded_hull->get_tangents(points[i])); });
+  runner.run("sharded/get_extremal_points/" + suffix, n_queries,
+      [&](size_t i) { bench::keep(sharded_hull->get_extremal_points(directions[i])); });
+  runner.run("sharded/get_num_points/" + suffix, n_queries,
+      [&](size_t) { bench::keep(sharded_hull->get_num_points()); });
+  runner.run("sharded/traverse_hull/" + suffix, 1, [&](size_t) {
+    size_t hull_size = 0;
+    auto count = [&](LineSegment<Field> const&) { hull_size++; };
+    sharded_hull->traverse_lower_hull(count), sharded_hull->traverse_upper_hull(count);
+    bench::keep(hull_size);
+  });
+}
+
+/* The single DynamicHull the sharded ones are measured against. */
+template<typename Field> void test_dynamic( bench::Runner& runner, std::string const& input, std::vector< Point<Field> > const& points ) {
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  runner.run("sharded/dynamic_add_point/" + input, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(); },
+      [&](size_t i) { dynamic_hull->add_point(points[i]); });
+  runner.run("sharded/dynamic_point_in_polygon/" + input, points.size() / 10,
+      [&](size_t i) { bench::keep(dynamic_hull->point_in_polygon(points[i])); });
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 20000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  unsigned n_threads = std::max(1u, std::thread::hardware_concurrency());
+  auto random_points = random_int_test<int64_t>(n_points);
+  auto circle_points = random_circle_int_test<int64_t>(n_points, n_points * 16);
+  test_dynamic(runner, "random", random_points);
+  test_dynamic(runner, "circle", circle_points);
+  for(int32_t n_shards: { 1, 4, 16 }) {
+    test_shards(runner, "random", random_points, n_shards, std::min< unsigned >(n_threads, n_shards));
+    test_shards(runner, "circle", circle_points, n_shards, std::min< unsigned >(n_threads, n_shards));
+  }
+
+  return runner.finish();
+}
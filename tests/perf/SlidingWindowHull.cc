@@ -0,0 +1,66 @@
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/SlidingWindowHull.hh>
+
+#include "Benchmark.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace dpch;
+
+/* A stream through a window of the given capacity: every public operation of the
+ * sliding window hull, against a DynamicHull that adds each sample and removes the
+ * oldest point. */
+template<typename Field> void test_window( bench::Runner& runner, std::string const& input,
+    std::vector< Point<Field> > const& points, int32_t capacity ) {
+  auto suffix = std::to_string(capacity) + "/" + input;
+  std::unique_ptr< SlidingWindowHull< Field > > window_hull;
+  auto filled = [&] {
+    window_hull = std::make_unique< SlidingWindowHull< Field > >(capacity);
+    for(auto const& point: points) window_hull->add_point(point);
+  };
+
+  runner.run("window/add_point/" + suffix, points.size(),
+      [&] { window_hull = std::make_unique< SlidingWindowHull< Field > >(capacity); },
+      [&](size_t i) { window_hull->add_point(points[i]); });
+  runner.run("window/remove_oldest_point/" + suffix, std::min< size_t >(capacity, points.size()), filled,
+      [&](size_t) { window_hull->remove_oldest_point(); });
+
+  filled();
+  auto queries = random_int_test<Field>(points.size()), directions = queries;
+  for(auto& direction: directions) direction = direction - Point<Field>(500000, 500000);
+  runner.run("window/get_oldest_point/" + suffix, queries.size(),
+      [&](size_t) { bench::keep(window_hull->get_oldest_point()); });
+  runner.run("window/point_in_polygon/" + suffix, queries.size(),
+      [&](size_t i) { bench::keep(window_hull->point_in_polygon(queries[i])); });
+  runner.run("window/get_tangents/" + suffix, queries.size(),
+      [&](size_t i) { bench::keep(window_hull->get_tangents(queries[i])); });
+  runner.run("window/get_extremal_points/" + suffix, directions.size(),
+      [&](size_t i) { bench::keep(window_hull->get_extremal_points(directions[i])); });
+
+  std::unique_ptr< DynamicHull< Field > > dynamic_hull;
+  runner.run("window/dynamic_slide/" + suffix, points.size(),
+      [&] { dynamic_hull = std::make_unique< DynamicHull< Field > >(); },
+      [&](size_t i) {
+        if( i >= size_t(capacity) ) dynamic_hull->remove_point(points[i - capacity]);
+        dynamic_hull->add_point(points[i]);
+      });
+}
+
+int main(int argc, char* argv[]) {
+  auto options = bench::parse(argc, argv, 50000);
+  int n_points = int(options.n_points);
+  bench::Runner runner(options);
+
+  auto random_points = random_int_test<int64_t>(n_points);
+  auto circle_points = random_circle_int_test<int64_t>(n_points, n_points * 16);
+  for(int32_t capacity: { 100, 10000, n_points / 2 }) {
+    test_window(runner, "random", random_points, capacity);
+    test_window(runner, "circle", circle_points, capacity);
+  }
+
+  return runner.finish();
+}
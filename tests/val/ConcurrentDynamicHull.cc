@@ -0,0 +1,221 @@
+/**
+ * Validating the versions published by ConcurrentDynamicHull against the live
+ * DynamicHull, sequentially and with readers running alongside the writer.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/ConcurrentDynamicHull.hh>
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace dpch;
+
+/* The batch queries of a frozen copy of the reader's version against single queries on the live hull. */
+template<typename T, typename Reader> void check_batch_queries(Reader const& reader, DynamicHull<T> const& hull,
+    std::vector< Point<T> > const& queries, unsigned threads) {
+  auto frozen = reader.freeze();
+  auto inside = frozen.point_in_polygon_batch(std::span< Point<T> const >(queries), threads);
+  auto tangents = frozen.get_tangents_batch(std::span< Point<T> const >(queries), threads);
+  assert(inside.size() == queries.size() and tangents.size() == queries.size());
+  for(size_t i = 0; i < queries.size(); i++) {
+    assert(bool(inside[i]) == hull.point_in_polygon(queries[i]));
+    assert(tangents[i] == hull.get_tangents(queries[i]));
+  }
+}
+
+/* As soon as an update returns, the reader's version has the writer's chains and answers queries like the live hull. */
+template<typename T> void check_version(ConcurrentDynamicHull<T> & concurrent_hull,
+    typename ConcurrentDynamicHull<T>::Reader const& reader, std::default_random_engine& random_engine) {
+  auto const& hull = concurrent_hull.get_hull();
+  std::vector< LineSegment<T> > lower, upper;
+  hull.traverse_lower_hull([&](LineSegment<T> const& segment) { lower.push_back(segment); });
+  hull.traverse_upper_hull([&](LineSegment<T> const& segment) { upper.push_back(segment); });
+
+  reader.read([&](DynamicHull<T> const& version) {
+      assert(version.get_num_points() == hull.get_num_points());
+      auto lower_iterator = lower.begin(), upper_iterator = upper.begin();
+      version.traverse_lower_hull([&](LineSegment<T> const& segment) { assert(segment.u == lower_iterator->u and segment.v == lower_iterator->v), lower_iterator++; });
+      version.traverse_upper_hull([&](LineSegment<T> const& segment) { assert(segment.u == upper_iterator->u and segment.v == upper_iterator->v), upper_iterator++; });
+      assert(lower_iterator == lower.end() and upper_iterator == upper.end());
+      return 0;
+      });
+
+  if( hull.get_num_points() < 3 ) return;
+  std::uniform_int_distribution< T > coordinate(-100000, 1100000);
+  for(int i = 0; i < 16; i++) {
+    Point<T> point(coordinate(random_engine), coordinate(random_engine));
+    assert(reader.point_in_polygon(point) == hull.point_in_polygon(point));
+    assert(reader.get_tangents(point) == hull.get_tangents(point));
+    assert(reader.get_extremal_points(point - Point<T>(500000, 500000)) ==
+        hull.get_extremal_points(point - Point<T>(500000, 500000)));
+  }
+
+  std::vector< Point<T> > directions;
+  for(int i = 0; i < 64; i++) directions.emplace_back(coordinate(random_engine) - 500000, coordinate(random_engine) - 500000);
+  reader.read([&](DynamicHull<T> const& version) {
+      auto batch = version.get_extremal_points_batch(std::span< Point<T> const >(directions));
+      for(size_t i = 0; i < directions.size(); i++) assert(batch[i] == hull.get_extremal_points(directions[i]));
+      return 0;
+      });
+
+  // batches of queries on the boundary and around it as well as anywhere
+  std::vector< Point<T> > queries;
+  for(int i = 0; i < 37; i++) queries.emplace_back(coordinate(random_engine), coordinate(random_engine));
+  for(auto const& segment: lower) {
+    queries.push_back(segment.u), queries.push_back(Point<T>(segment.u.x, segment.u.y - 1));
+    queries.push_back(Point<T>(segment.u.x, segment.u.y + 1)), queries.push_back(Point<T>(segment.u.x - 1, segment.u.y));
+    queries.push_back(Point<T>((segment.u.x + segment.v.x) / 2, (segment.u.y + segment.v.y) / 2));
+  }
+  for(auto const& segment: upper)
+    queries.push_back(segment.v), queries.push_back(Point<T>(segment.v.x, segment.v.y + 1)), queries.push_back(Point<T>(segment.v.x + 1, segment.v.y));
+  check_batch_queries(reader, hull, queries, 1);
+}
+
+/* Before anything is added, and once everything is removed again, the version is empty:
+ * it encloses nothing, has no tangents and answers every query without touching a segment. */
+template<typename T> void test_empty( std::vector< Point<T> > const& points ) {
+  ConcurrentDynamicHull<T> concurrent_hull;
+  auto reader = concurrent_hull.reader();
+  std::vector< Point<T> > queries = { Point<T>(1, 1), Point<T>(0, 0), Point<T>(-5, 7) };
+  auto check = [&] {
+    assert(reader.get_hull_size() == 0);
+    for(auto const& query: queries) {
+      assert(not reader.point_in_polygon(query));
+      assert(reader.get_tangents(query) == std::nullopt);
+    }
+    auto frozen = reader.freeze();
+    auto inside = frozen.point_in_polygon_batch(std::span< Point<T> const >(queries));
+    auto tangents = frozen.get_tangents_batch(std::span< Point<T> const >(queries));
+    for(size_t i = 0; i < queries.size(); i++)
+      assert(not inside[i] and tangents[i] == std::nullopt);
+  };
+  check();
+  for(auto const& point: points) concurrent_hull.add_point(point);
+  for(auto const& point: points) concurrent_hull.remove_point(point);
+  check();
+  auto const& hull = concurrent_hull.get_hull();
+  for(auto const& query: queries)
+    assert(not hull.point_in_polygon(query) and hull.get_tangents(query) == std::nullopt);
+}
+
+template<typename T> void test_val( std::vector< Point<T> > const& points ) {
+  static std::default_random_engine random_engine;
+  ConcurrentDynamicHull<T> concurrent_hull;
+  auto reader = concurrent_hull.reader();
+
+  for(auto const& point: points) {
+    concurrent_hull.add_point(point);
+    check_version(concurrent_hull, reader, random_engine);
+  }
+  for(auto const& point: points) {
+    assert(concurrent_hull.remove_point(point));
+    check_version(concurrent_hull, reader, random_engine);
+  }
+}
+
+/* A version held by a reader keeps its chains while the writer updates the hull,
+ * frees the nodes of the versions it replaces and outgrows the storage of segments. */
+template<typename T> void test_held( std::vector< Point<T> > const& points ) {
+  ConcurrentDynamicHull<T> concurrent_hull;
+  auto reader = concurrent_hull.reader();
+  auto half = points.size() / 2;
+  for(size_t i = 0; i < half; i++) concurrent_hull.add_point(points[i]);
+  reader.read([&](DynamicHull<T> const& version) {
+      std::vector< LineSegment<T> > chains;
+      auto collect = [&](LineSegment<T> const& segment) { chains.push_back(segment); };
+      version.traverse_lower_hull(collect), version.traverse_upper_hull(collect);
+      for(size_t i = half; i < points.size(); i++) concurrent_hull.add_point(points[i]);
+      for(size_t i = 0; i < points.size(); i += 2) assert(concurrent_hull.remove_point(points[i]));
+      std::vector< LineSegment<T> > held;
+      version.traverse_lower_hull([&](LineSegment<T> const& segment) { held.push_back(segment); });
+      version.traverse_upper_hull([&](LineSegment<T> const& segment) { held.push_back(segment); });
+      assert(held == chains and version.get_num_points() == (int)half);
+      return 0;
+      });
+  assert(concurrent_hull.get_hull().get_num_points() == (int)(points.size() / 2));
+}
+
+/* Readers walk every version they get while the writer keeps replacing it and
+ * growing the storage of segments: each must be a pair of closed convex chains,
+ * however long the reader holds on to it. */
+template<typename T> void test_concurrent( std::vector< Point<T> > const& points, int n_readers ) {
+  ConcurrentDynamicHull<T> concurrent_hull;
+  std::atomic<bool> done = false;
+  std::atomic<int64_t> reads = 0;
+
+  std::vector< std::thread > readers;
+  for(int i = 0; i < n_readers; i++) readers.emplace_back([&] {
+      auto reader = concurrent_hull.reader();
+      while( not done.load() ) {
+        reader.read([](DynamicHull<T> const& version) {
+            std::vector< LineSegment<T> > lower, upper;
+            version.traverse_lower_hull([&](LineSegment<T> const& segment) { lower.push_back(segment); });
+            version.traverse_upper_hull([&](LineSegment<T> const& segment) { upper.push_back(segment); });
+            for(size_t j = 1; j < lower.size(); j++)
+              assert(lower[j-1].v == lower[j].u and (lower[j-1].v - lower[j-1].u) * (lower[j].v - lower[j].u) > 0);
+            for(size_t j = 1; j < upper.size(); j++)
+              assert(upper[j-1].v == upper[j].u and (upper[j-1].v - upper[j-1].u) * (upper[j].v - upper[j].u) < 0);
+            if( not lower.empty() ) assert(lower.front().u == upper.front().u and lower.back().v == upper.back().v);
+            assert(version.get_hull_size() == int(lower.size() + upper.size()));
+            return 0;
+            });
+        reads++;
+      }
+      });
+
+  std::default_random_engine random_engine;
+  std::vector< Point<T> > present;
+  for(auto const& point: points) {
+    concurrent_hull.add_point(point), present.push_back(point);
+    if( present.size() > 16 and random_engine() % 3 == 0 ) {
+      std::swap(present[random_engine() % present.size()], present.back());
+      assert(concurrent_hull.remove_point(present.back()));
+      present.pop_back();
+    }
+  }
+  done = true;
+  for(auto &reader: readers) reader.join();
+  assert(concurrent_hull.get_hull().get_num_points() == (int)present.size());
+  std::cout << reads.load() << " version reads" << std::endl;
+}
+
+int main() {
+  std::cout << "empty hull test" << std::endl;
+  test_empty(random_int_test<int64_t>(100));
+
+  std::vector< size_t > sizes = { 10, 10, 10, 50, 50, 100, 100, 500, 1000, 2000 };
+
+  for(auto n_points: sizes) {
+    std::cout << "random test with " << std::setw(6) << n_points << " points" << std::endl;
+    test_val(random_int_test<int64_t>(n_points));
+    std::cout << "circle test with " << std::setw(6) << n_points << " points" << std::endl;
+    test_val(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false));
+  }
+
+  {
+    std::cout << "batch queries" << std::endl;
+    ConcurrentDynamicHull<int64_t> concurrent_hull;
+    auto reader = concurrent_hull.reader();
+    for(auto const& point: random_circle_int_test<int64_t>(3000, 1000000, false)) concurrent_hull.add_point(point);
+    auto queries = random_int_test<int64_t>(100000);
+    for(auto& query: queries) query = Point<int64_t>(query.x * 3 - 1500000, query.y * 3 - 1500000);
+    check_batch_queries(reader, concurrent_hull.get_hull(), queries, 4);
+  }
+
+  std::cout << "held versions" << std::endl;
+  test_held(random_int_test<int64_t>(5000));
+  test_held(random_circle_int_test<int64_t>(5000, 1000000, false));
+
+  test_concurrent(random_int_test<int64_t>(5000), 3);
+  test_concurrent(random_circle_int_test<int64_t>(5000, 1000000, false), 3);
+
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}
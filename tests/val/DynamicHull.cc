@@ -8,8 +8,10 @@
 #include <dpch/util/LineSegment.hh>
 #include <dpch/util/TestGenerator.hh>
 #include <dpch/util/Tangent.hh>
+#include <dpch/util/FieldTraits.hh>
 #include <dpch/static/ConvexHull.hh>
 #include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/FrozenHull.hh>
 
 #include <chrono>
 #include <cmath>
@@ -18,10 +20,14 @@
 #include <iomanip>
 #include <vector>
 #include <cassert>
+#include <tuple>
+#include <span>
+#include <thread>
+#include <algorithm>
 
 using namespace dpch;
 
-template<typename T> void test_extremes(Point<T> const& point, DynamicHull<T> & dynamic_hull,
+template<typename Hull, typename T> void test_extremes(Point<T> const& point, Hull & dynamic_hull,
     std::vector< Point<T> > const& lower_chain, std::vector< Point<T> > const& upper_chain ) {
   if( lower_chain.size() <= 1 ) return;
   if( upper_chain.size() <= 1 ) return;
@@ -58,6 +64,73 @@ template<typename T> void test_extremes(Point<T> const& point, DynamicHull<T> &
 
 }
 
+/* Area, perimeter and centroid of a hull against the shoelace formula over the static
+ * chains, taken from their first vertex; the area is exact, the others close. */
+template<typename Hull, typename T> void check_measures( Hull const& hull,
+    std::vector< Point<T> > const& lower_chain, std::vector< Point<T> > const& upper_chain ) {
+  std::vector< Point<T> > polygon(lower_chain);
+  polygon.insert(polygon.end(), upper_chain.rbegin() + 1, upper_chain.rend() - 1);
+  auto origin = polygon[0];
+  __int128 twice_area = 0;
+  double perimeter = 0, moment_x = 0, moment_y = 0;
+  for(size_t i = 0; i < polygon.size(); i++) {
+    auto p = polygon[i] - origin, q = polygon[(i + 1) % polygon.size()] - origin;
+    auto term = cross(p, q);
+    twice_area += term;
+    perimeter += std::sqrt(double(q.x - p.x) * double(q.x - p.x) + double(q.y - p.y) * double(q.y - p.y));
+    moment_x += double(term) * double(p.x + q.x), moment_y += double(term) * double(p.y + q.y);
+  }
+  Point<double> centroid = twice_area == 0
+    ? Point<double>(double(lower_chain.front().x + lower_chain.back().x) / 2, double(lower_chain.front().y + lower_chain.back().y) / 2)
+    : Point<double>(origin.x + moment_x / (3 * double(twice_area)), origin.y + moment_y / (3 * double(twice_area)));
+
+  assert(hull.area() == double(twice_area) / 2);
+  assert(std::abs(hull.perimeter() - perimeter) <= 1e-9 * perimeter);
+  double scale = 1 + std::abs(double(origin.x)) + std::abs(double(origin.y));
+  assert(std::abs(hull.centroid().x - centroid.x) <= 1e-9 * scale and std::abs(hull.centroid().y - centroid.y) <= 1e-9 * scale);
+}
+
+/* Stepping iterators through a chain, both ways and back from either end, against traverse(). */
+template<typename Chain> void check_iterators( Chain const& chain ) {
+  std::vector< LineSegment<int64_t> > segments;
+  chain.traverse([&segments](LineSegment<int64_t> const& seg) { segments.push_back(seg); });
+  size_t i = 0;
+  for(auto it = chain.begin(); it != chain.end(); ++it, i++) assert(*it == segments[i]);
+  assert(i == segments.size());
+  for(auto it = chain.rbegin(); it != chain.rend(); ++it) assert(*it == segments[--i]);
+  assert(i == 0);
+  auto it = chain.end();
+  for(size_t j = segments.size(); j-- > 0; ) assert(*--it == segments[j]);
+  if( segments.size() < 3 ) return;
+  it = chain.begin(), ++it, ++it, --it;
+  assert(*it == segments[1]);
+}
+
+/* Chains of a hull against those of a static hull, which may be computed in a wider type. */
+template<typename T, typename Summary, typename W> void check_chains( DynamicHull<T, Summary> const& dynamic_hull,
+    std::vector< Point<W> > const& lower_chain, std::vector< Point<W> > const& upper_chain ) {
+  auto upper_chain_iterator = upper_chain.begin();
+  auto check_upper_chain = [&upper_chain_iterator](LineSegment< T > const&seg)
+  { ++upper_chain_iterator, assert(seg.v.x == upper_chain_iterator->x and seg.v.y == upper_chain_iterator->y); };
+  auto lower_chain_iterator = lower_chain.begin();
+  auto check_lower_chain = [&lower_chain_iterator](LineSegment< T > const&seg)
+  { assert(seg.u.x == lower_chain_iterator->x and seg.u.y == lower_chain_iterator->y), ++lower_chain_iterator; };
+  dynamic_hull.traverse_lower_hull(check_lower_chain);
+  dynamic_hull.traverse_upper_hull(check_upper_chain);
+  assert(dynamic_hull.get_hull_size() == (int)(lower_chain.size() + upper_chain.size() - 2));
+  if constexpr ( std::is_same_v< Summary, ChainSummary<T> > and std::is_same_v< W, T > )
+    check_measures(dynamic_hull, lower_chain, upper_chain);
+}
+
+/* Chains of a hull against the static hull of a set of points. */
+template<typename T, typename Summary> void check_chains( DynamicHull<T, Summary> const& dynamic_hull, std::vector< Point<T> > points ) {
+  assert(dynamic_hull.get_num_points() == (int)points.size());
+  if( points.size() < 3 ) return;
+  std::sort(points.begin(), points.end());
+  auto [lower_chain, upper_chain] = convex_hull(points, true);
+  check_chains(dynamic_hull, lower_chain, upper_chain);
+}
+
 template<typename T> void test_val( std::vector< Point<T> > const& points ) {
 
   static std::default_random_engine random_engine;
@@ -70,7 +143,7 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
   auto iter = points.begin();
   std::vector< Point<int64_t> > polygon;
 
-  DynamicHull< int64_t > dynamic_hull;
+  DynamicHull< int64_t, ChainSummary<int64_t> > dynamic_hull;
 
   auto [lower_chain, upper_chain] = convex_hull(polygon, true);
 
@@ -84,7 +157,7 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
 
 
     polygon.insert( std::lower_bound(polygon.begin(), polygon.end(), point), point);
-    tie(lower_chain, upper_chain) = convex_hull(polygon, false, false);
+    std::tie(lower_chain, upper_chain) = convex_hull(polygon, false, false);
 
     dynamic_hull.add_point(point);
 
@@ -96,14 +169,23 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
       << std::setw(6) << points.size() << ") [" << std::setw(6) << (lower_chain.size() + upper_chain.size() - 2) << " ] "
       << std::setw(6) << dynamic_hull.get_hull_size() << "]\r";
 
-    auto upper_chain_iterator = upper_chain.begin();
-    auto check_upper_chain = [&upper_chain_iterator](LineSegment< int64_t > const&seg) { assert(seg.v == *(++upper_chain_iterator)); };
-    auto lower_chain_iterator = lower_chain.begin();
-    auto check_lower_chain = [&lower_chain_iterator](LineSegment< int64_t > const&seg) { assert(seg.u == *lower_chain_iterator++); };
-    dynamic_hull.traverse_lower_hull(check_lower_chain);
-    dynamic_hull.traverse_upper_hull(check_upper_chain);
+    check_chains(dynamic_hull, lower_chain, upper_chain);
+    check_iterators(dynamic_hull.get_lower_hull()), check_iterators(dynamic_hull.get_upper_hull());
   };
 
+  {
+    DynamicHull< int64_t > bulk_hull(points.begin(), points.end());
+    assert(bulk_hull.get_num_points() == dynamic_hull.get_num_points());
+    assert(bulk_hull.get_hull_size() == dynamic_hull.get_hull_size());
+
+    check_chains(bulk_hull, lower_chain, upper_chain);
+  }
+
+  {
+    DynamicHull< int64_t > parallel_hull(points.begin(), points.end(), false, 4);
+    check_chains(parallel_hull, lower_chain, upper_chain);
+  }
+
   iter = points.begin();
   while( iter != points.end() ) {
     auto const&point = *iter++;
@@ -115,7 +197,7 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
 
     polygon.erase(std::find(polygon.begin(), polygon.end(), point));
 
-    tie(lower_chain, upper_chain) = convex_hull(polygon, false, false);
+    std::tie(lower_chain, upper_chain) = convex_hull(polygon, false, false);
     dynamic_hull.remove_point(point);
 
     if( polygon.size() < 3 ) continue;
@@ -127,18 +209,286 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
       << std::setw(6) << (lower_chain.size() + upper_chain.size() - 2) << " ] "
       << std::setw(6) << dynamic_hull.get_hull_size() << "]\r";
 
-    auto upper_chain_iterator = upper_chain.begin();
-    auto check_upper_chain = [&upper_chain_iterator](LineSegment< int64_t > const&seg) { assert(seg.v == *(++upper_chain_iterator)); };
-    auto lower_chain_iterator = lower_chain.begin();
-    auto check_lower_chain = [&lower_chain_iterator](LineSegment< int64_t > const&seg) { assert(seg.u == *lower_chain_iterator++); };
-    dynamic_hull.traverse_lower_hull(check_lower_chain);
-    dynamic_hull.traverse_upper_hull(check_upper_chain);
+    check_chains(dynamic_hull, lower_chain, upper_chain);
+  };
+
+}
+
+/* Mixed batches of insertions and deletions against the static hull of what is left. */
+template<typename T> void test_batch( std::vector< Point<T> > const& points ) {
+  static std::default_random_engine random_engine;
+
+  DynamicHull< T > dynamic_hull;
+  std::vector< Point<T> > present, absent = points;
+
+  for(int round = 0; round < 8; round++) {
+    std::shuffle(present.begin(), present.end(), random_engine);
+    std::shuffle(absent.begin(), absent.end(), random_engine);
+    auto n_deletes = std::uniform_int_distribution< size_t >(0, present.size())(random_engine);
+    auto n_inserts = std::uniform_int_distribution< size_t >(0, absent.size())(random_engine);
+
+    std::vector< Point<T> > deletes(present.end() - n_deletes, present.end());
+    std::vector< Point<T> > inserts(absent.end() - n_inserts, absent.end());
+    present.resize(present.size() - n_deletes), absent.resize(absent.size() - n_inserts);
+    present.insert(present.end(), inserts.begin(), inserts.end());
+    absent.insert(absent.end(), deletes.begin(), deletes.end());
+
+    auto removed = dynamic_hull.apply_batch(inserts, deletes, 1 + round % 2);
+    assert(removed == (int)deletes.size());
+    check_chains(dynamic_hull, present);
+  }
+}
+
+/* Forks updated independently of each other and of the hull they were forked from,
+ * their measures included. */
+template<typename T> void test_fork( std::vector< Point<T> > const& points ) {
+  static std::default_random_engine random_engine;
+  if( points.size() < 8 ) return;
+
+  using Hull = DynamicHull< T, ChainSummary<T> >;
+  auto half = points.begin() + points.size() / 2;
+  Hull dynamic_hull(points.begin(), half);
+  std::vector< Point<T> > present(points.begin(), half), absent(half, points.end());
+
+  std::vector< std::pair< Hull, std::vector< Point<T> > > > versions;
+  for(int round = 0; round < 6; round++) {
+    versions.emplace_back(dynamic_hull.fork(), present);
+    if( round % 3 == 2 ) {
+      auto& [other, other_points] = versions[std::uniform_int_distribution< size_t >(0, versions.size() - 1)(random_engine)];
+      auto fork = other.fork();
+      versions.emplace_back(std::move(fork), std::vector< Point<T> >(other_points));
+    }
+    auto& [hull, hull_points] = versions[std::uniform_int_distribution< size_t >(0, versions.size() - 1)(random_engine)];
+
+    std::shuffle(hull_points.begin(), hull_points.end(), random_engine);
+    std::vector< Point<T> > deletes(hull_points.end() - std::min< size_t >(hull_points.size() - 1, 8), hull_points.end());
+    for(size_t i = 0; i < deletes.size() / 2; i++) assert(hull.remove_point(deletes[i]));
+    hull.apply_batch({}, std::span< Point<T> const >(deletes.begin() + deletes.size() / 2, deletes.end()));
+    hull_points.resize(hull_points.size() - deletes.size());
+
+    std::shuffle(absent.begin(), absent.end(), random_engine);
+    auto n_inserts = std::min< size_t >(absent.size(), 4);
+    for(size_t i = 0; i < n_inserts; i++) dynamic_hull.add_point(absent[i]);
+    present.insert(present.end(), absent.begin(), absent.begin() + n_inserts);
+    absent.erase(absent.begin(), absent.begin() + n_inserts);
+
+    check_chains(dynamic_hull, present);
+    for(auto const& [version, version_points]: versions) check_chains(version, version_points);
+    if( round % 2 ) versions.erase(versions.begin());
+  }
+
+  Hull moved(std::move(dynamic_hull));
+  check_chains(moved, present);
+  dynamic_hull = moved.fork();
+  check_chains(dynamic_hull, present);
+  for(auto const& [version, version_points]: versions) check_chains(version, version_points);
+}
+
+/* Forks updated and dropped while the original changes too: every segment a fork
+ * copies goes with it, so memory stays where it started. Once the forks are gone a
+ * parallel batch works on the original alone. */
+template<typename T> void test_fork_memory( std::vector< Point<T> > const& points ) {
+  static std::default_random_engine random_engine;
+  DynamicHull< T > dynamic_hull(points.begin(), points.end());
+  std::uniform_int_distribution< size_t > random_index(0, points.size() - 1);
+  auto baseline = dynamic_hull.get_num_segments();
+  for(size_t round = 0; round < 2000; round++) {
+    {
+      auto fork = dynamic_hull.fork();
+      fork.remove_point(points[random_index(random_engine)]);
+      auto point = points[random_index(random_engine)];
+      assert(dynamic_hull.remove_point(point));
+      dynamic_hull.add_point(point);
+    }
+    assert(dynamic_hull.get_num_segments() <= 2 * baseline);
+  }
+  auto fork = dynamic_hull.fork();
+  for(size_t i = 0; i < 16; i++) fork.remove_point(points[i]);
+  fork = DynamicHull< T >();
+  dynamic_hull.apply_batch({}, std::span< Point<T> const >(points).first(points.size() / 2), 4);
+  check_chains(dynamic_hull, std::vector< Point<T> >(points.begin() + points.size() / 2, points.end()));
+}
+
+/* Stepping through the chains with iterators, both ways, against traverse(). */
+template<typename T> void test_iterators( std::vector< Point<T> > const& points ) {
+  DynamicHull< T > dynamic_hull(points.begin(), points.end());
+  auto fork = dynamic_hull.fork();
+  fork.remove_point(points[0]), fork.remove_point(points[1]);
+  for(auto const* hull: { &dynamic_hull, &fork }) {
+    auto const& chain = hull->get_lower_hull();
+    std::vector< LineSegment<T> > segments;
+    chain.traverse([&](LineSegment<T> const& segment) { segments.push_back(segment); });
+    auto it = chain.begin();
+    for(auto const& segment: segments) assert(*it == segment), ++it;
+    assert(it == chain.end());
+    for(auto segment = segments.rbegin(); segment != segments.rend(); ++segment) --it, assert(*it == *segment);
+    assert(it == chain.begin());
+    auto rit = chain.rbegin();
+    for(auto segment = segments.rbegin(); segment != segments.rend(); ++segment) assert(*rit == *segment), ++rit;
+    assert(rit == chain.rend());
+    auto middle = chain.binary_search([&](auto const& iter) { return not (iter->u < segments[segments.size() / 2].u); });
+    assert(*middle == segments[segments.size() / 2] and *++middle == segments[segments.size() / 2 + 1]);
+  }
+}
+
+/* Independent hulls updated from several threads at once, each with its own seed. */
+template<typename T> void test_threads( std::vector< Point<T> > const& points ) {
+  std::vector< std::thread > threads;
+  for(unsigned t = 0; t < 8; t++) threads.emplace_back([&points, t] {
+    std::vector< Point<T> > shuffled(points);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::default_random_engine(t));
+    DynamicHull< T > dynamic_hull;
+    dynamic_hull.seed(t);
+    for(auto const& point: shuffled) dynamic_hull.add_point(point);
+    for(size_t i = 0; i < shuffled.size() / 4; i++) dynamic_hull.remove_point(shuffled[i]);
+    check_chains(dynamic_hull, std::vector< Point<T> >(shuffled.begin() + shuffled.size() / 4, shuffled.end()));
+  });
+  for(auto& thread: threads) thread.join();
+}
+
+/* Coordinates far beyond what products in the storage type can hold, against a
+ * static hull computed in 128 bit arithmetic. */
+template<typename T> void test_wide( size_t n_points, T range, bool circle ) {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< T > random_coordinate(-range, range);
+  std::vector< Point<T> > points(n_points);
+  for(size_t i = 0; i < n_points; i++) {
+    if( circle ) {
+      double angle = 2 * acos(-1) * i / n_points;
+      points[i] = Point<T>(T(range * cos(angle)), T(range * sin(angle)));
+    } else {
+      points[i] = Point<T>(random_coordinate(random_engine), random_coordinate(random_engine));
+    }
+  }
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  std::shuffle(points.begin(), points.end(), random_engine);
+
+  DynamicHull< T > dynamic_hull;
+  for(auto const& point: points) dynamic_hull.add_point(point);
+  auto removed = dynamic_hull.apply_batch({}, std::span< Point<T> const >(points.data(), points.size() / 4));
+  assert(removed == (int)(points.size() / 4));
+
+  std::vector< Point<__int128> > polygon;
+  for(size_t i = points.size() / 4; i < points.size(); i++) polygon.emplace_back(points[i].x, points[i].y);
+  std::sort(polygon.begin(), polygon.end());
+  auto [lower_chain, upper_chain] = convex_hull(polygon, true);
+
+  check_chains(dynamic_hull, lower_chain, upper_chain);
+
+  for(auto const& vertex: {lower_chain.front(), lower_chain.back(), upper_chain[upper_chain.size() / 2]}) {
+    auto direction = Point<T>(T(vertex.x), T(vertex.y));
+    __int128 farthest = vertex ^ vertex;
+    for(auto const& point: polygon) farthest = std::max(farthest, point ^ vertex);
+    auto [u, v] = dynamic_hull.get_extremal_points(direction);
+    assert(dot(u, direction) == farthest and dot(v, direction) == farthest);
+  }
+}
+
+/* get_extremal_points_batch against single queries, on hulls big enough to be swept, for
+ * directions out of angular order: random ones, repeats at other lengths, the axes and
+ * zero, and normals of hull edges, whose farthest points are the two ends of the edge. */
+template<typename T, typename Hull> void check_extremal_batch( Hull const& hull, std::vector< LineSegment<T> > const& segments ) {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< int64_t > coordinate(-1000000, 1000000);
+  std::vector< Point<T> > directions;
+  for(size_t i = 0; i < segments.size() / 2; i++) directions.emplace_back(coordinate(random_engine), coordinate(random_engine));
+  for(size_t i = 0; i < segments.size(); i += 5) {
+    auto edge = segments[i].v - segments[i].u;
+    directions.emplace_back(-edge.y, edge.x), directions.emplace_back(edge.y, -edge.x);
+    directions.push_back(directions[i / 5]), directions.back().x *= 3, directions.back().y *= 3;
+  }
+  for(auto direction: { Point<T>(0, 0), Point<T>(1, 0), Point<T>(-1, 0), Point<T>(0, 1), Point<T>(0, -1), Point<T>(1000000, 1) })
+    directions.push_back(direction);
+  std::shuffle(directions.begin(), directions.end(), random_engine);
+
+  auto batch = hull.get_extremal_points_batch(std::span< Point<T> const >(directions));
+  assert(batch.size() == directions.size());
+  for(size_t i = 0; i < directions.size(); i++) assert(batch[i] == hull.get_extremal_points(directions[i]));
+}
+
+template<typename T> void test_extremal_batch( std::vector< Point<T> > const& points ) {
+  DynamicHull< T > dynamic_hull(points.begin(), points.end());
+  std::vector< LineSegment<T> > segments;
+  dynamic_hull.traverse_lower_hull([&](LineSegment<T> const& segment) { segments.push_back(segment); });
+  dynamic_hull.traverse_upper_hull([&](LineSegment<T> const& segment) { segments.push_back(segment); });
+  check_extremal_batch< T >(dynamic_hull, segments);
+  check_extremal_batch< T >(FrozenHull< T >(dynamic_hull), segments);
+  // fewer directions than the sweep needs give the same answers one at a time
+  std::vector< Point<T> > few(points.begin(), points.begin() + 16);
+  auto batch = dynamic_hull.get_extremal_points_batch(std::span< Point<T> const >(few));
+  for(size_t i = 0; i < few.size(); i++) assert(batch[i] == dynamic_hull.get_extremal_points(few[i]));
+}
+
+/* The batch queries of a frozen copy against single queries on the hull, at its vertices,
+ * next to them and halfway along its segments as well as anywhere around it. */
+template<typename T> void test_frozen_batch( std::vector< Point<T> > const& points ) {
+  DynamicHull< T > dynamic_hull(points.begin(), points.end());
+  FrozenHull< T > frozen_hull(dynamic_hull);
+  std::vector< Point<T> > queries;
+  auto around = [&](LineSegment<T> const& segment) {
+    queries.push_back(segment.u), queries.push_back(Point<T>(segment.u.x, segment.u.y - 1));
+    queries.push_back(Point<T>(segment.u.x, segment.u.y + 1)), queries.push_back(Point<T>(segment.u.x - 1, segment.u.y));
+    queries.push_back(Point<T>(segment.v.x + 1, segment.v.y));
+    queries.push_back(Point<T>((segment.u.x + segment.v.x) / 2, (segment.u.y + segment.v.y) / 2));
   };
+  dynamic_hull.traverse_lower_hull(around);
+  dynamic_hull.traverse_upper_hull(around);
+  for(auto const& query: random_int_test<int64_t>(points.size() + 100))
+    queries.emplace_back(T(query.x + query.x / 5 - 100000), T(query.y + query.y / 5 - 100000));
+
+  for(unsigned threads: { 1, 2 }) {
+    auto inside = frozen_hull.point_in_polygon_batch(std::span< Point<T> const >(queries), threads);
+    auto tangents = frozen_hull.get_tangents_batch(std::span< Point<T> const >(queries), threads);
+    assert(inside.size() == queries.size() and tangents.size() == queries.size());
+    for(size_t i = 0; i < queries.size(); i++) {
+      assert(bool(inside[i]) == dynamic_hull.point_in_polygon(queries[i]));
+      assert(tangents[i] == dynamic_hull.get_tangents(queries[i]));
+    }
+  }
+}
 
+/* Hulls without area: a point, a segment, and collinear points until one more gives
+ * them a triangle. */
+void test_degenerate_measures() {
+  DynamicHull< int64_t, ChainSummary<int64_t> > dynamic_hull;
+  dynamic_hull.add_point(Point<int64_t>(3, 5));
+  assert(dynamic_hull.area() == 0 and dynamic_hull.perimeter() == 0);
+  assert(dynamic_hull.centroid().x == 3 and dynamic_hull.centroid().y == 5);
+  for(int64_t i = 1; i <= 4; i++) dynamic_hull.add_point(Point<int64_t>(3 + 3 * i, 5 + 4 * i));
+  assert(dynamic_hull.area() == 0 and std::abs(dynamic_hull.perimeter() - 40) < 1e-9);
+  assert(dynamic_hull.centroid().x == 9 and dynamic_hull.centroid().y == 13);
+  dynamic_hull.add_point(Point<int64_t>(15, 5));
+  assert(dynamic_hull.area() == 96 and std::abs(dynamic_hull.perimeter() - 48) < 1e-9);
+  assert(std::abs(dynamic_hull.centroid().x - 11) < 1e-9 and std::abs(dynamic_hull.centroid().y - 31. / 3) < 1e-9);
+  assert(dynamic_hull.remove_point(Point<int64_t>(15, 5)) and dynamic_hull.area() == 0);
 }
 
+/* A small hull moved far from the origin keeps its area exactly and its centroid to
+ * within the rounding of the offset. */
+void test_offset_measures() {
+  std::vector< Point<int64_t> > points = { Point<int64_t>(0, 0), Point<int64_t>(11, 1), Point<int64_t>(10, 10),
+    Point<int64_t>(3, 9), Point<int64_t>(-1, 4), Point<int64_t>(5, 5) };
+  auto measure = [&](Point<int64_t> const& offset) {
+    DynamicHull< int64_t, ChainSummary<int64_t> > hull;
+    for(auto const& point: points) hull.add_point(point + offset);
+    return std::make_pair(hull.area(), hull.centroid());
+  };
+  auto [area, centroid] = measure(Point<int64_t>(0, 0));
+  for(int64_t shift: { int64_t(100000000), int64_t(1000000000), int64_t(1) << 40, int64_t(1) << 61 })
+    for(auto offset: { Point<int64_t>(shift, shift), Point<int64_t>(-shift, shift / 3) }) {
+      auto [offset_area, offset_centroid] = measure(offset);
+      assert(offset_area == area);
+      double tolerance = 1e-12 * double(shift);
+      assert(std::abs(offset_centroid.x - (centroid.x + double(offset.x))) <= tolerance);
+      assert(std::abs(offset_centroid.y - (centroid.y + double(offset.y))) <= tolerance);
+    }
+}
 
 int main() {
+  test_degenerate_measures();
+  test_offset_measures();
+
   std::vector< size_t > sizes = { 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
     50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 100, 100, 100, 100, 100, 500, 500, 500, 500, 500,
     1000, 1000, 1000, 2000, 2000, 2000 };
@@ -148,16 +498,53 @@ int main() {
       auto random_test = random_int_test<int64_t>(n_points);
       std::cout << "\nrandom test with " << std::setw(6) << n_points << " points" << std::endl;
       test_val(random_test);
+      test_batch(random_test);
+      test_fork(random_test);
+      test_threads(random_test);
     }
     {
       std::cout << "\ncircle test with " << std::setw(6) << n_points << " points" << std::endl;
       auto random_test = random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false);
       test_val(random_test);
+      test_batch(random_test);
+      test_fork(random_test);
     }
     {
       std::cout << "\nspiral test with " << std::setw(6) << n_points << " points" << std::endl;
       auto random_test = random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), true);
       test_val(random_test);
+      test_batch(random_test);
+      test_fork(random_test);
+    }
+  }
+  std::cout << "\nfork memory test" << std::endl;
+  test_fork_memory(random_circle_int_test<int64_t>(5000, 2 * 5000 * 70, false));
+  test_fork_memory(random_int_test<int64_t>(5000));
+  test_iterators(random_circle_int_test<int64_t>(1000, 2 * 1000 * 31, false));
+  test_iterators(random_int_test<int64_t>(1000));
+  for(size_t n_points: { 5000, 20000 }) {
+    std::cout << "\nextremal batch test with " << std::setw(6) << n_points << " points" << std::endl;
+    test_extremal_batch(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false));
+    test_extremal_batch(random_int_test<int64_t>(n_points));
+  }
+  for(size_t n_points: { 1, 2, 3, 10, 100, 1000, 5000 }) {
+    std::cout << "\nfrozen batch test with " << std::setw(6) << n_points << " points" << std::endl;
+    for(bool circle: { false, true }) {
+      auto test = circle ? random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)) + 100, false) :
+        random_int_test<int64_t>(n_points);
+      test_frozen_batch(test);
+      std::vector< Point<int32_t> > narrow;
+      std::vector< Point<double> > halves;
+      for(auto const& point: test) narrow.emplace_back(point.x, point.y), halves.emplace_back(point.x * 0.5, point.y * 0.5);
+      test_frozen_batch(narrow);
+      test_frozen_batch(halves);
+    }
+  }
+  for(size_t n_points: { 10, 100, 1000, 5000 }) {
+    std::cout << "\nwide coordinate test with " << std::setw(6) << n_points << " points" << std::endl;
+    for(bool circle: { false, true }) {
+      test_wide< int32_t >(n_points, (1 << 30) - 1, circle);
+      test_wide< int64_t >(n_points, (int64_t(1) << 40) - 1, circle);
     }
   }
   std::cout << "\nall tests passed" << std::endl;
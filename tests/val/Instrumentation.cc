@@ -0,0 +1,113 @@
+/**
+ * Validating the instrumentation, built with DPCH_INSTRUMENT: one trace per
+ * outermost update, traces adding up to the stats of the instance, and
+ * counters that move with the work the updates do.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/online/OnlineHull.hh>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <span>
+#include <algorithm>
+
+using namespace dpch;
+
+#ifndef DPCH_INSTRUMENT
+#error "build with -DDPCH_INSTRUMENT"
+#endif
+
+/* Sums the traces of an instance, and counts them by operation. */
+struct Recorder {
+  HullStats total;
+  std::vector< std::string > operations;
+  void operator()(HullTrace const& trace) {
+    assert(trace.work.operations == 1);
+    total.add(trace.work);
+    operations.push_back(trace.operation);
+  }
+  size_t count(std::string const& operation) const { return std::count(operations.begin(), operations.end(), operation); }
+};
+
+void check_total(HullStats const& stats, HullStats const& total) {
+  assert(stats.operations == total.operations);
+  assert(stats.pushes == total.pushes and stats.pulls == total.pulls);
+  assert(stats.bridges == total.bridges and stats.bridge_steps == total.bridge_steps);
+  assert(stats.allocated == total.allocated and stats.freed == total.freed);
+  assert(stats.cuts == total.cuts and stats.joins == total.joins);
+  assert(stats.cut_depth == total.cut_depth and stats.join_depth == total.join_depth);
+  assert(stats.height == total.height);
+}
+
+void test_dynamic(std::vector< Point<int64_t> > const& points) {
+  DynamicHull< int64_t > dynamic_hull;
+  Recorder recorder;
+  dynamic_hull.set_trace([&](HullTrace const& trace) { recorder(trace); });
+
+  for(auto const& point: points) dynamic_hull.add_point(point);
+  auto const& stats = dynamic_hull.get_stats();
+  assert(recorder.count("add_point") == points.size() and stats.operations == points.size());
+  assert(stats.pushes > 0 and stats.pulls > 0 and stats.bridges > 0 and stats.bridge_steps >= stats.bridges);
+  assert(stats.allocated > 0 and stats.cuts > 0 and stats.joins > 0);
+  assert(stats.cut_depth > 0 and stats.join_depth > 0 and stats.height > 1);
+
+  std::span< Point<int64_t> const > half(points.data(), points.size() / 2);
+  for(auto const& point: half) assert(dynamic_hull.remove_point(point));
+  assert(recorder.count("remove_point") == half.size());
+  dynamic_hull.apply_batch(half, {});
+  assert(recorder.count("apply_batch") == 1);
+  dynamic_hull.assign(points.begin(), points.end());
+  assert(recorder.count("assign") == 1);
+  check_total(stats, recorder.total);
+  assert(stats.freed > 0 and stats.freed <= stats.allocated);
+
+  // a move carries the stats along, and a reset clears them
+  HullStats before = stats;
+  DynamicHull< int64_t > moved = std::move(dynamic_hull);
+  assert(moved.get_stats().operations == before.operations);
+  moved.reset_stats();
+  assert(moved.get_stats().operations == 0 and moved.get_stats().pushes == 0);
+  moved.add_point(Point<int64_t>(-1, -1));
+  assert(moved.get_stats().operations == 1 and recorder.count("add_point") == points.size() + 1);
+
+  // queries are not updates
+  size_t n_traces = recorder.operations.size();
+  moved.point_in_polygon(points[0]);
+  moved.get_tangents(Point<int64_t>(-5, -5));
+  assert(recorder.operations.size() == n_traces and moved.get_stats().operations == 1);
+}
+
+void test_online(std::vector< Point<int64_t> > const& points) {
+  OnlineHull< int64_t > online_hull(points[0], points[1]);
+  Recorder recorder;
+  online_hull.set_trace([&](HullTrace const& trace) { recorder(trace); });
+
+  for(size_t i = 2; i < points.size() / 2; i++) online_hull.add_point(points[i]);
+  assert(recorder.count("add_point") == points.size() / 2 - 2);
+  // a batch is a single operation, whatever it calls inside
+  online_hull.add_points(std::span< Point<int64_t> const >(points).subspan(points.size() / 2));
+  assert(recorder.count("add_points") == 1 and recorder.operations.size() == points.size() / 2 - 1);
+
+  auto const& stats = online_hull.get_stats();
+  check_total(stats, recorder.total);
+  assert(stats.allocated > 0 and stats.cuts > 0 and stats.joins > 0);
+  assert(stats.cut_depth > 0 and stats.join_depth > 0);
+  assert(stats.pushes == 0 and stats.bridges == 0);
+}
+
+int main() {
+  std::cout << "dynamic hull" << std::endl;
+  test_dynamic(random_circle_int_test<int64_t>(2000, 1000000, false));
+  test_dynamic(random_int_test<int64_t>(2000));
+
+  std::cout << "online hull" << std::endl;
+  test_online(random_circle_int_test<int64_t>(2000, 1000000, false));
+  test_online(random_int_test<int64_t>(2000));
+
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}
@@ -5,6 +5,7 @@
 #include <dpch/util/Point.hh>
 #include <dpch/util/TestGenerator.hh>
 #include <dpch/util/Tangent.hh>
+#include <dpch/util/FieldTraits.hh>
 #include <dpch/static/ConvexHull.hh>
 #include <dpch/online/OnlineHull.hh>
 
@@ -15,10 +16,13 @@
 #include <iomanip>
 #include <vector>
 #include <cassert>
+#include <tuple>
+#include <span>
+#include <algorithm>
 
 using namespace dpch;
 
-template<typename T> void test_extremes(Point<T> const& point, OnlineHull<T> & dynamic_hull,
+template<typename Hull, typename T> void test_extremes(Point<T> const& point, Hull const& dynamic_hull,
     std::vector< Point<T> > const& lower_chain, std::vector< Point<T> > const& upper_chain ) {
   std::vector< Point<T> > polygon;
   polygon.insert(polygon.begin(), lower_chain.begin(), lower_chain.end() - 1);
@@ -30,6 +34,11 @@ template<typename T> void test_extremes(Point<T> const& point, OnlineHull<T> & d
   auto [test_outside, test_tangents] = dynamic_hull.get_tangents(point);
 
   assert(outside == test_outside);
+
+  bool inside = true;
+  for(size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+    inside &= (polygon[i] - polygon[j]) * (point - polygon[j]) > 0;
+  assert(inside == dynamic_hull.point_in_polygon(point));
   if( outside ) {
     assert(tangents.first == test_tangents.first);
     assert(tangents.second == test_tangents.second);
@@ -50,6 +59,32 @@ template<typename T> void test_extremes(Point<T> const& point, OnlineHull<T> & d
   }
 }
 
+/* Area, perimeter and centroid of a hull against the shoelace formula over the static
+ * chains, taken from their first vertex; the area is exact, the others close. */
+template<typename Hull, typename T> void check_measures( Hull const& hull,
+    std::vector< Point<T> > const& lower_chain, std::vector< Point<T> > const& upper_chain ) {
+  std::vector< Point<T> > polygon(lower_chain);
+  polygon.insert(polygon.end(), upper_chain.rbegin() + 1, upper_chain.rend() - 1);
+  auto origin = polygon[0];
+  __int128 twice_area = 0;
+  double perimeter = 0, moment_x = 0, moment_y = 0;
+  for(size_t i = 0; i < polygon.size(); i++) {
+    auto p = polygon[i] - origin, q = polygon[(i + 1) % polygon.size()] - origin;
+    auto term = cross(p, q);
+    twice_area += term;
+    perimeter += std::sqrt(double(q.x - p.x) * double(q.x - p.x) + double(q.y - p.y) * double(q.y - p.y));
+    moment_x += double(term) * double(p.x + q.x), moment_y += double(term) * double(p.y + q.y);
+  }
+  Point<double> centroid = twice_area == 0
+    ? Point<double>(double(lower_chain.front().x + lower_chain.back().x) / 2, double(lower_chain.front().y + lower_chain.back().y) / 2)
+    : Point<double>(origin.x + moment_x / (3 * double(twice_area)), origin.y + moment_y / (3 * double(twice_area)));
+
+  assert(hull.area() == double(twice_area) / 2);
+  assert(std::abs(hull.perimeter() - perimeter) <= 1e-9 * perimeter);
+  double scale = 1 + std::abs(double(origin.x)) + std::abs(double(origin.y));
+  assert(std::abs(hull.centroid().x - centroid.x) <= 1e-9 * scale and std::abs(hull.centroid().y - centroid.y) <= 1e-9 * scale);
+}
+
 template<typename T> void test_val( std::vector< Point<T> > const& points ) {
   assert( points.size() > 2 );
 
@@ -60,7 +95,7 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
   polygon[1] = *iter++;
   std::sort(polygon.begin(), polygon.end());
 
-  OnlineHull< int64_t > dynamic_hull(polygon[0], polygon[1]);
+  OnlineHull< int64_t, ChainSummary<int64_t> > dynamic_hull(polygon[0], polygon[1]);
 
   auto [lower_chain, upper_chain] = convex_hull(polygon, true);
 
@@ -69,8 +104,13 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
     test_extremes(point, dynamic_hull, lower_chain, upper_chain);
     polygon.insert(std::lower_bound(polygon.begin(), polygon.end(), point), point);
 
-    tie(lower_chain, upper_chain) = convex_hull(polygon, true);
+    std::tie(lower_chain, upper_chain) = convex_hull(polygon, true);
+    auto cache_hits = dynamic_hull.get_cache_hits();
     dynamic_hull.add_point(point);
+    if( dynamic_hull.get_cache_hits() > cache_hits ) { // only interior points may hit the cache
+      assert(std::find(lower_chain.begin(), lower_chain.end(), point) == lower_chain.end());
+      assert(std::find(upper_chain.begin(), upper_chain.end(), point) == upper_chain.end());
+    }
 
     std::cout << "(" << std::setw(6) << polygon.size() << "/"
       << std::setw(6) << points.size() << ") ["
@@ -90,10 +130,108 @@ template<typename T> void test_val( std::vector< Point<T> > const& points ) {
 
     assert(dynamic_hull.get_lower_hull_size() == lower_chain.size());
     assert(dynamic_hull.get_upper_hull_size() == upper_chain.size());
+    check_measures(dynamic_hull, lower_chain, upper_chain);
+  };
+}
+
+/* Bulk construction from a prefix, then batches of varying sizes. */
+template<typename T> void test_batch( std::vector< Point<T> > const& points ) {
+  if( points.size() < 4 ) return;
+
+  static std::default_random_engine random_engine;
+  auto iter = points.begin() + 2;
+  OnlineHull< T, ChainSummary<T> > dynamic_hull(std::span< Point<T> const >(points.begin(), iter));
+
+  std::vector< Point<T> > polygon(points.begin(), iter);
+  while( iter != points.end() ) {
+    auto batch_size = std::uniform_int_distribution< size_t >(1, points.size() / 4 + 1)(random_engine);
+    auto next = iter + std::min< size_t >(batch_size, points.end() - iter);
+    dynamic_hull.add_points(std::span< Point<T> const >(iter, next));
+    polygon.insert(polygon.end(), iter, next);
+    iter = next;
+
+    std::sort(polygon.begin(), polygon.end());
+    auto [lower_chain, upper_chain] = convex_hull(polygon, true);
+
+    auto lower_chain_iterator = lower_chain.begin();
+    auto upper_chain_iterator = upper_chain.begin();
+    dynamic_hull.traverse_lower_hull([&lower_chain_iterator](Point< T > const&point)
+        { assert(point == *lower_chain_iterator++); });
+    assert(lower_chain_iterator == lower_chain.end());
+    dynamic_hull.traverse_upper_hull([&upper_chain_iterator](Point< T > const&point)
+        { assert(point == *upper_chain_iterator++); });
+    assert(upper_chain_iterator == upper_chain.end());
+    check_measures(dynamic_hull, lower_chain, upper_chain);
+  }
+}
+
+/* A segment, collinear points, and one more point that makes a triangle of them. */
+void test_degenerate_measures() {
+  OnlineHull< int64_t, ChainSummary<int64_t> > online_hull(Point<int64_t>(15, 21), Point<int64_t>(3, 5));
+  assert(online_hull.area() == 0 and std::abs(online_hull.perimeter() - 40) < 1e-9);
+  assert(online_hull.centroid().x == 9 and online_hull.centroid().y == 13);
+  online_hull.add_point(Point<int64_t>(9, 13));
+  assert(online_hull.area() == 0 and std::abs(online_hull.perimeter() - 40) < 1e-9);
+  online_hull.add_point(Point<int64_t>(15, 5));
+  assert(online_hull.area() == 96 and std::abs(online_hull.perimeter() - 48) < 1e-9);
+  assert(std::abs(online_hull.centroid().x - 11) < 1e-9 and std::abs(online_hull.centroid().y - 31. / 3) < 1e-9);
+}
+
+/* get_extremal_points_batch against single queries on a hull big enough to be swept, for
+ * directions out of angular order: random ones, repeats at other lengths, the axes and
+ * zero, and normals of hull edges, whose farthest points are the two ends of the edge. */
+template<typename T> void test_extremal_batch( std::vector< Point<T> > const& points ) {
+  static std::default_random_engine random_engine;
+  OnlineHull< T > online_hull{std::span< Point<T> const >(points)};
+  std::vector< Point<T> > hull;
+  online_hull.traverse_lower_hull([&](Point<T> const& point) { hull.push_back(point); });
+  online_hull.traverse_upper_hull([&](Point<T> const& point) { hull.push_back(point); });
+
+  std::uniform_int_distribution< int64_t > coordinate(-1000000, 1000000);
+  std::vector< Point<T> > directions;
+  for(size_t i = 0; i < hull.size() / 2; i++) directions.emplace_back(coordinate(random_engine), coordinate(random_engine));
+  for(size_t i = 0; i + 1 < hull.size(); i += 5) {
+    auto edge = hull[i + 1] - hull[i];
+    directions.emplace_back(-edge.y, edge.x), directions.emplace_back(edge.y, -edge.x);
+    directions.push_back(directions[i / 5]), directions.back().x *= 3, directions.back().y *= 3;
+  }
+  for(auto direction: { Point<T>(0, 0), Point<T>(1, 0), Point<T>(-1, 0), Point<T>(0, 1), Point<T>(0, -1), Point<T>(1000000, 1) })
+    directions.push_back(direction);
+  std::shuffle(directions.begin(), directions.end(), random_engine);
+
+  auto batch = online_hull.get_extremal_points_batch(std::span< Point<T> const >(directions));
+  assert(batch.size() == directions.size());
+  for(size_t i = 0; i < directions.size(); i++) assert(batch[i] == online_hull.get_extremal_points(directions[i]));
+
+  // fewer directions than the sweep needs give the same answers one at a time
+  batch = online_hull.get_extremal_points_batch(std::span< Point<T> const >(directions).first(16));
+  for(size_t i = 0; i < 16; i++) assert(batch[i] == online_hull.get_extremal_points(directions[i]));
+}
+
+/* A small hull moved far from the origin keeps its area exactly and its centroid to
+ * within the rounding of the offset. */
+void test_offset_measures() {
+  std::vector< Point<int64_t> > points = { Point<int64_t>(0, 0), Point<int64_t>(11, 1), Point<int64_t>(10, 10),
+    Point<int64_t>(3, 9), Point<int64_t>(-1, 4), Point<int64_t>(5, 5) };
+  auto measure = [&](Point<int64_t> const& offset) {
+    OnlineHull< int64_t, ChainSummary<int64_t> > hull(points[0] + offset, points[1] + offset);
+    for(size_t i = 2; i < points.size(); i++) hull.add_point(points[i] + offset);
+    return std::make_pair(hull.area(), hull.centroid());
   };
+  auto [area, centroid] = measure(Point<int64_t>(0, 0));
+  for(int64_t shift: { int64_t(100000000), int64_t(1000000000), int64_t(1) << 40, int64_t(1) << 61 })
+    for(auto offset: { Point<int64_t>(shift, shift), Point<int64_t>(-shift, shift / 3) }) {
+      auto [offset_area, offset_centroid] = measure(offset);
+      assert(offset_area == area);
+      double tolerance = 1e-12 * double(shift);
+      assert(std::abs(offset_centroid.x - (centroid.x + double(offset.x))) <= tolerance);
+      assert(std::abs(offset_centroid.y - (centroid.y + double(offset.y))) <= tolerance);
+    }
 }
 
 int main() {
+  test_degenerate_measures();
+  test_offset_measures();
 
   std::vector< size_t > sizes = { 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
     50, 50, 50, 50, 50, 50, 50, 50, 50, 50, 100, 100, 100, 100, 100,
@@ -104,18 +242,26 @@ int main() {
       auto random_test = random_int_test<int64_t>(n_points);
       std::cout << "random test with " << std::setw(6) << n_points << " points" << std::endl;
       test_val(random_test);
+      test_batch(random_test);
     }
     {
       std::cout << "circle test with " << std::setw(6) << n_points << " points" << std::endl;
       auto random_test = random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false);
       test_val(random_test);
+      test_batch(random_test);
     }
     {
       std::cout << "spiral test with " << std::setw(6) << n_points << " points" << std::endl;
       auto random_test = random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), true);
       test_val(random_test);
+      test_batch(random_test);
     }
   }
+  for(size_t n_points: { 5000, 20000 }) {
+    std::cout << "extremal batch test with " << std::setw(6) << n_points << " points" << std::endl;
+    test_extremal_batch(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false));
+    test_extremal_batch(random_int_test<int64_t>(n_points));
+  }
   std::cout << "\nall tests passed" << std::endl;
 
   return 0;
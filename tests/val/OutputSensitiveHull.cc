@@ -0,0 +1,82 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/OutputSensitiveHull.hh>
+
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace dpch;
+
+/* Chan's algorithm against the monotone chain, with and without collinear points. */
+template<typename T> void test_val( std::vector< Point<T> > const& points ) {
+  for(bool collinear: { false, true }) {
+    auto [lower_chain, upper_chain] = convex_hull(points, false, collinear);
+    auto [wrapped_lower, wrapped_upper] = output_sensitive_convex_hull(points, collinear);
+    assert(wrapped_lower == lower_chain);
+    assert(wrapped_upper == upper_chain);
+  }
+}
+
+/* Points within a few ulps of a line, where an unfiltered cross product is wrong. */
+std::vector< Point<double> > nearly_collinear_test(size_t n_points) {
+  static std::default_random_engine random_engine;
+  std::uniform_real_distribution< double > position(0, 1);
+  std::uniform_int_distribution< int > ulps(-2, 2);
+  std::vector< Point<double> > points;
+  for(size_t i = 0; i < n_points; i++) {
+    double x = position(random_engine), y = x / 3;
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 1.0);
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 0.0);
+    points.emplace_back(x, y);
+  }
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  std::shuffle(points.begin(), points.end(), random_engine);
+  return points;
+}
+
+int main() {
+  std::vector< size_t > sizes = { 1, 2, 3, 10, 20, 100, 1000, 10000, 100000, 1000000 };
+
+  for(auto n_points: sizes) {
+    {
+      std::cout << "random test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_int_test<int64_t>(n_points));
+    }
+    {
+      std::cout << "grid test with   " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_int_test<int64_t>(n_points, 64));
+    }
+    {
+      std::cout << "wide test with   " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_int_test<int32_t>(n_points, 1 << 30));
+    }
+    {
+      std::cout << "nearly collinear test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(nearly_collinear_test(n_points));
+    }
+    {
+      std::cout << "line test with   " << std::setw(7) << n_points << " points" << std::endl;
+      auto points = random_int_test<int64_t>(n_points);
+      for(auto &point: points) point.y = 3 * point.x + 7;
+      std::sort(points.begin(), points.end());
+      points.erase(std::unique(points.begin(), points.end()), points.end());
+      std::shuffle(points.begin(), points.end(), std::default_random_engine(42));
+      test_val(points);
+    }
+    if( n_points >= 3 ) {
+      std::cout << "circle test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), false));
+      std::cout << "spiral test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_circle_int_test<int64_t>(n_points, n_points * (int)(sqrt(n_points)), true));
+    }
+  }
+
+  return 0;
+}
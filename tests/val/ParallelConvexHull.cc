@@ -0,0 +1,110 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/RadixSort.hh>
+#include <dpch/static/ParallelConvexHull.hh>
+
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace dpch;
+
+/* Radix sort and parallel sort against std::sort, with negative coordinates and
+ * repeated x; sorting by x alone, merges then cut runs of ties. */
+template<typename T> void test_sort( std::vector< Point<T> > points ) {
+  for(auto &point: points) point.x = point.x / 64 - 8000, point.y = -point.y;
+  auto expected = points;
+  std::sort(expected.begin(), expected.end());
+  auto by_x = [](Point<T> const& a, Point<T> const& b) { return a.x < b.x; };
+  for(unsigned threads: { 1, 2, 4 }) {
+    auto sorted = points;
+    ForkJoin pool(threads);
+    radix_sort(std::span< Point<T> >(sorted), pool);
+    assert(sorted == expected);
+    for(std::ptrdiff_t grain = 7 + points.size() / 4096; grain < (std::ptrdiff_t)points.size(); grain *= 37) {
+      sorted = points;
+      parallel_sort(pool, sorted.begin(), sorted.end(), by_x, grain);
+      assert(std::is_sorted(sorted.begin(), sorted.end(), by_x));
+      std::sort(sorted.begin(), sorted.end());
+      assert(sorted == expected);
+    }
+  }
+}
+
+/* Parallel hull against the sequential monotone chain. */
+template<typename T> void test_val( std::vector< Point<T> > const& points ) {
+  auto sorted_points = points;
+  std::sort(sorted_points.begin(), sorted_points.end());
+  for(bool collinear: { false, true }) {
+    auto [lower_chain, upper_chain] = convex_hull(points, false, collinear);
+    for(unsigned threads: { 1, 2, 3, 8 }) {
+      auto polygon = points;
+      auto [parallel_lower, parallel_upper] = parallel_convex_hull(std::span< Point<T> >(polygon), threads, false, collinear);
+      assert(parallel_lower == lower_chain);
+      assert(parallel_upper == upper_chain);
+      std::sort(polygon.begin(), polygon.end()); // prefiltered points are left unsorted
+      assert(std::equal(polygon.begin(), polygon.end(), sorted_points.begin()));
+    }
+  }
+}
+
+/* Points within a few ulps of a line, where an unfiltered cross product is wrong. */
+std::vector< Point<double> > nearly_collinear_test(size_t n_points) {
+  static std::default_random_engine random_engine;
+  std::uniform_real_distribution< double > position(0, 1);
+  std::uniform_int_distribution< int > ulps(-2, 2);
+  std::vector< Point<double> > points;
+  for(size_t i = 0; i < n_points; i++) {
+    double x = position(random_engine), y = x / 3;
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 1.0);
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 0.0);
+    points.emplace_back(x, y);
+  }
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  std::shuffle(points.begin(), points.end(), random_engine);
+  return points;
+}
+
+int main() {
+  std::vector< size_t > sizes = { 1, 2, 3, 10, 100, 1000, 10000, 100000, 1000000 };
+
+  for(auto n_points: sizes) {
+    {
+      std::cout << "random test with " << std::setw(7) << n_points << " points" << std::endl;
+      auto random_test = random_int_test<int64_t>(n_points);
+      test_sort(random_test);
+      test_val(random_test);
+    }
+    {
+      std::cout << "narrow test with " << std::setw(7) << n_points << " points" << std::endl;
+      auto random_test = random_int_test<int32_t>(n_points, 1 << 12);
+      test_val(random_test);
+    }
+    {
+      std::cout << "wide test with   " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_int_test<int32_t>(n_points, 1 << 30));
+    }
+    if( n_points >= 3 ) {
+      std::cout << "circle test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false));
+      std::cout << "spiral test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), true));
+    }
+    {
+      std::cout << "double test with " << std::setw(7) << n_points << " points" << std::endl;
+      std::vector< Point<double> > points;
+      for(auto point: random_int_test<int64_t>(n_points)) points.emplace_back(point.x * 0.5, point.y * 0.25);
+      test_val(points);
+      std::cout << "nearly collinear test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(nearly_collinear_test(n_points));
+    }
+  }
+
+  return 0;
+}
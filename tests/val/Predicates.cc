@@ -0,0 +1,133 @@
+/**
+ * Validating the floating point predicates against exact integer arithmetic,
+ * and the hulls over doubles on nearly collinear inputs.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Predicates.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/online/OnlineHull.hh>
+
+#include <cmath>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+using namespace dpch;
+
+template<typename T> int sign(T const& value) { return (value > 0) - (value < 0); }
+
+/* Points a few ulps around (0.5, 0.5) against the line through (12, 12) and (24, 24);
+ * everything scaled by 2^53 is an integer, and exact in 128 bits. */
+void test_orientation_grid() {
+  double ulp = std::ldexp(1.0, -53);
+  auto scale = [](double x) { return (__int128)std::ldexp(x, 53); };
+  Point<double> q(12, 12), r(24, 24);
+  int wrong = 0;
+  for(int i = 0; i < 256; i++) for(int j = 0; j < 256; j++) {
+    Point<double> p(0.5 + i * ulp, 0.5 + j * ulp);
+    auto exact = (scale(q.x) - scale(p.x)) * (scale(r.y) - scale(p.y)) -
+      (scale(q.y) - scale(p.y)) * (scale(r.x) - scale(p.x));
+    assert(sign(orientation(p, q, r)) == sign(exact));
+    assert(sign(orientation(q, r, p)) == sign(exact));
+    wrong += sign(cross(q - p, r - p)) != sign(exact);
+  }
+  std::cout << "grid: plain doubles get " << wrong << " of 65536 orientations wrong" << std::endl;
+}
+
+/* Integers below 2^40 are exact doubles, and int64_t predicates are exact on them. */
+void test_orientation_random() {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< int64_t > coordinate(-(int64_t(1) << 40), int64_t(1) << 40);
+  std::uniform_int_distribution< int64_t > offset(-2, 2);
+  for(int i = 0; i < 100000; i++) {
+    Point<int64_t> o(coordinate(random_engine), coordinate(random_engine));
+    Point<int64_t> p(coordinate(random_engine), coordinate(random_engine));
+    auto t = std::uniform_int_distribution< int64_t >(-4, 4)(random_engine);
+    Point<int64_t> q = o + (p - o) * t + Point<int64_t>(offset(random_engine), offset(random_engine));
+    Point<double> _o(o.x, o.y), _p(p.x, p.y), _q(q.x, q.y);
+    assert(sign(orientation(_o, _p, _q)) == sign(orientation(o, p, q)));
+    assert(sign(projection(_o, _p, _q)) == sign(projection(o, p, q)));
+    auto normal = Point<int64_t>(o.y - p.y, p.x - o.x) + Point<int64_t>(offset(random_engine), 0);
+    Point<double> _normal(normal.x, normal.y);
+    assert(sign(projection(_o, _p, _normal)) == sign(projection(o, p, normal)));
+  }
+}
+
+/* Two lines crossing x = split at the same height, give or take one unit. */
+void test_split_order() {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< int64_t > coordinate(-(int64_t(1) << 28), int64_t(1) << 28);
+  std::uniform_int_distribution< int64_t > step(1, int64_t(1) << 20);
+  for(int i = 0; i < 100000; i++) {
+    Point<int64_t> meet(coordinate(random_engine), coordinate(random_engine));
+    Point<int64_t> dl(step(random_engine), coordinate(random_engine) >> 8);
+    Point<int64_t> dr(step(random_engine), coordinate(random_engine) >> 8);
+    auto shift = Point<int64_t>(0, std::uniform_int_distribution< int64_t >(-1, 1)(random_engine));
+    LineSegment<int64_t> left(meet - dl * 3, meet - dl * 2);
+    LineSegment<int64_t> right(meet + dr * 2 + shift, meet + dr * 3 + shift);
+    LineSegment<double> _left(Point<double>(left.u.x, left.u.y), Point<double>(left.v.x, left.v.y));
+    LineSegment<double> _right(Point<double>(right.u.x, right.u.y), Point<double>(right.v.x, right.v.y));
+    auto split = meet.x + std::uniform_int_distribution< int64_t >(-2, 2)(random_engine);
+    assert(sign(split_order(_left, _right, double(split))) == sign(split_order(left, right, split)));
+  }
+}
+
+/* Points within a few ulps of a line: the dynamic, online and static hulls agree. */
+void test_hulls(size_t n_points) {
+  static std::default_random_engine random_engine;
+  std::uniform_real_distribution< double > position(0, 1);
+  std::uniform_int_distribution< int > ulps(-2, 2);
+  std::vector< Point<double> > points;
+  for(size_t i = 0; i < n_points; i++) {
+    double x = position(random_engine), y = x / 3;
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 1.0);
+    for(int k = ulps(random_engine); k > 0; k--) y = std::nextafter(y, 0.0);
+    points.emplace_back(x, y);
+  }
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  std::shuffle(points.begin(), points.end(), random_engine);
+
+  DynamicHull< double > dynamic_hull;
+  OnlineHull< double > online_hull(std::span< Point<double> const >(points.data(), 2));
+  std::vector< Point<double> > polygon(points.begin(), points.begin() + 2);
+  for(size_t i = 0; i < points.size(); i++) {
+    dynamic_hull.add_point(points[i]);
+    if( i >= 2 ) online_hull.add_point(points[i]), polygon.push_back(points[i]);
+    if( i % 64 != 63 and i + 1 != points.size() ) continue;
+
+    std::sort(polygon.begin(), polygon.end());
+    auto [lower_chain, upper_chain] = convex_hull(polygon, true);
+    auto lower_iterator = lower_chain.begin(), upper_iterator = upper_chain.begin();
+    dynamic_hull.traverse_lower_hull([&](LineSegment<double> const& seg) { assert(seg.u == *lower_iterator++); });
+    dynamic_hull.traverse_upper_hull([&](LineSegment<double> const& seg) { assert(seg.v == *(++upper_iterator)); });
+
+    lower_iterator = lower_chain.begin(), upper_iterator = upper_chain.begin();
+    online_hull.traverse_lower_hull([&](Point<double> const& point) { assert(point == *lower_iterator++); });
+    assert(lower_iterator == lower_chain.end());
+    online_hull.traverse_upper_hull([&](Point<double> const& point) { assert(point == *upper_iterator++); });
+    assert(upper_iterator == upper_chain.end());
+
+    for(size_t j = 0; j + 2 < lower_chain.size(); j++)
+      assert(orientation(lower_chain[j], lower_chain[j+1], lower_chain[j+2]) > 0);
+    for(size_t j = 0; j + 2 < upper_chain.size(); j++)
+      assert(orientation(upper_chain[j], upper_chain[j+1], upper_chain[j+2]) < 0);
+  }
+}
+
+int main() {
+  test_orientation_grid();
+  test_orientation_random();
+  test_split_order();
+  for(size_t n_points: { 10, 100, 1000, 5000 }) {
+    std::cout << "nearly collinear test with " << std::setw(6) << n_points << " points" << std::endl;
+    test_hulls(n_points);
+  }
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <dpch/util/Point.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/static/Prefilter.hh>
+
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace dpch;
+
+/* The prefilter keeps a stable subsequence, permutes the rest behind it, and never
+ * drops a point of either chain, collinear points included. */
+template<typename T> void test_val( std::vector< Point<T> > const& points ) {
+  auto [lower_chain, upper_chain] = convex_hull(points, false, true);
+
+  auto filtered = points;
+  auto kept = prefilter(std::span< Point<T> >(filtered));
+  assert(kept <= points.size());
+
+  std::vector< Point<T> > survivors(filtered.begin(), filtered.begin() + kept);
+  auto position = points.begin();
+  for(auto const& point: survivors) {
+    position = std::find(position, points.end(), point);
+    assert(position != points.end());
+  }
+
+  auto sorted_points = points, sorted_filtered = filtered;
+  std::sort(sorted_points.begin(), sorted_points.end());
+  std::sort(sorted_filtered.begin(), sorted_filtered.end());
+  assert(sorted_points == sorted_filtered);
+
+  std::sort(survivors.begin(), survivors.end());
+  for(auto const chain: { &lower_chain, &upper_chain })
+    for(auto const& point: *chain)
+      assert(std::binary_search(survivors.begin(), survivors.end(), point));
+}
+
+int main() {
+  std::vector< size_t > sizes = { 1, 2, 3, 10, 100, 1000, 10000, 100000, 1000000 };
+
+  for(auto n_points: sizes) {
+    std::cout << "random test with " << std::setw(7) << n_points << " points" << std::endl;
+    auto random_test = random_int_test<int64_t>(n_points);
+    test_val(random_test);
+
+    std::vector< Point<int32_t> > narrow;
+    for(auto point: random_test) narrow.emplace_back(int32_t(point.x / 64), int32_t(point.y / 64)); // cross products fit
+    std::sort(narrow.begin(), narrow.end());
+    narrow.erase(std::unique(narrow.begin(), narrow.end()), narrow.end());
+    test_val(narrow);
+
+    std::vector< Point<double> > real;
+    for(auto point: random_test) real.emplace_back(point.x * 1e-3, point.y * 1e-3);
+    test_val(real);
+
+    std::cout << "grid test with   " << std::setw(7) << n_points << " points" << std::endl;
+    test_val(random_int_test<int64_t>(n_points, 64));
+
+    if( n_points >= 3 ) {
+      std::cout << "circle test with " << std::setw(7) << n_points << " points" << std::endl;
+      test_val(random_circle_int_test<int64_t>(n_points, 2 * n_points * (int)(sqrt(n_points)), false));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * Validating the sharded hull against a single DynamicHull holding the same
+ * points, itself validated against the static ConvexHull and util/Tangent.hh.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/TestGenerator.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+#include <dpch/dynamic/ShardedDynamicHull.hh>
+
+#include <cmath>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <cassert>
+#include <algorithm>
+
+using namespace dpch;
+
+template<typename Hull> std::vector< std::pair< Point<int64_t>, Point<int64_t> > > chain_of(Hull const& hull, bool lower) {
+  std::vector< std::pair< Point<int64_t>, Point<int64_t> > > chain;
+  auto collect = [&chain](LineSegment<int64_t> const& seg) { chain.emplace_back(seg.u, seg.v); };
+  if( lower ) hull.traverse_lower_hull(collect);
+  else hull.traverse_upper_hull(collect);
+  return chain;
+}
+
+/* Chains, sizes and queries at random points, at hull vertices and in many directions. */
+void test_equal(ShardedDynamicHull<int64_t> const& sharded_hull, DynamicHull<int64_t> const& dynamic_hull, int64_t range) {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< int64_t > coordinate(-range / 4, range + range / 4);
+
+  assert(sharded_hull.get_num_points() == dynamic_hull.get_num_points());
+  if( dynamic_hull.get_num_points() == 0 ) return;
+  auto lower = chain_of(dynamic_hull, true), upper = chain_of(dynamic_hull, false);
+  assert(chain_of(sharded_hull, true) == lower);
+  assert(chain_of(sharded_hull, false) == upper);
+  assert(sharded_hull.get_lower_hull_size() == int32_t(lower.size()));
+  assert(sharded_hull.get_upper_hull_size() == int32_t(upper.size()));
+  assert(sharded_hull.get_hull_size() == dynamic_hull.get_hull_size());
+
+  std::vector< Point<int64_t> > queries = { lower.front().first, lower.back().second, lower[lower.size() / 2].first };
+  for(int i = 0; i < 8; i++) queries.emplace_back(coordinate(random_engine), coordinate(random_engine));
+  for(auto const& point: queries) {
+    assert(sharded_hull.point_in_polygon(point) == dynamic_hull.point_in_polygon(point));
+    assert(sharded_hull.get_tangents(point) == dynamic_hull.get_tangents(point));
+  }
+
+  static int const n_directions = 64;
+  static double const omega = 2 * acos(-1) / n_directions;
+  for(int i = 0; i < n_directions; i++) {
+    auto direction = Point< int64_t >( 1000000 * cos(i * omega), 1000000 * sin(i * omega) );
+    assert(sharded_hull.get_extremal_points(direction) == dynamic_hull.get_extremal_points(direction));
+  }
+}
+
+/* Single updates with a merge after each, then deletions in random order. */
+void test_updates(std::vector< Point<int64_t> > const& points, int32_t n_shards, int64_t range) {
+  ShardedDynamicHull< int64_t > sharded_hull(n_shards);
+  DynamicHull< int64_t > dynamic_hull;
+  for(auto const& point: points) {
+    sharded_hull.add_point(point), dynamic_hull.add_point(point);
+    sharded_hull.merge();
+    test_equal(sharded_hull, dynamic_hull, range);
+  }
+
+  std::vector< Point<int64_t> > order(points);
+  std::shuffle(order.begin(), order.end(), std::default_random_engine(n_shards));
+  for(auto const& point: order) {
+    assert(sharded_hull.remove_point(point) == dynamic_hull.remove_point(point));
+    sharded_hull.merge();
+    test_equal(sharded_hull, dynamic_hull, range);
+  }
+}
+
+/* Batches, some of which shift the distribution far enough to move the boundaries. */
+void test_batches(std::vector< Point<int64_t> > const& points, int32_t n_shards, int64_t range) {
+  ShardedDynamicHull< int64_t > sharded_hull(n_shards);
+  DynamicHull< int64_t > dynamic_hull;
+  std::default_random_engine random_engine(n_shards);
+  size_t batch = std::max< size_t >(1, points.size() / 16);
+  for(size_t first = 0; first < points.size(); first += batch) {
+    std::span< Point<int64_t> const > inserts(points.data() + first, std::min(batch, points.size() - first));
+    std::vector< Point<int64_t> > deletes;
+    for(size_t i = 0; i < first; i++) if( random_engine() % 4 == 0 ) deletes.push_back(points[i]);
+    assert(sharded_hull.apply_batch(inserts, deletes, 2) == dynamic_hull.apply_batch(inserts, deletes));
+    test_equal(sharded_hull, dynamic_hull, range);
+  }
+
+  int32_t largest = 0;
+  for(int32_t i = 0; i < n_shards; i++) largest = std::max(largest, sharded_hull.get_shard_size(i));
+  assert(largest <= 2 * (sharded_hull.get_num_points() / n_shards) + 16);
+}
+
+/* Writers on their own threads, each to points of all shards, then a merge. */
+void test_threads(std::vector< Point<int64_t> > const& points, int32_t n_shards, int64_t range) {
+  ShardedDynamicHull< int64_t > sharded_hull(n_shards);
+  sharded_hull.apply_batch(std::span< Point<int64_t> const >(points.data(), points.size() / 2), {});
+
+  std::vector< std::thread > writers;
+  for(size_t t = 0; t < 4; t++) writers.emplace_back([&, t] {
+    for(size_t i = points.size() / 2 + t; i < points.size(); i += 4) sharded_hull.add_point(points[i]);
+    for(size_t i = t; i < points.size() / 2; i += 8) sharded_hull.remove_point(points[i]);
+  });
+  for(auto& writer: writers) writer.join();
+  sharded_hull.merge();
+
+  DynamicHull< int64_t > dynamic_hull(points.begin(), points.end());
+  for(size_t i = 0; i < points.size() / 2; i++) if( i % 8 < 4 ) dynamic_hull.remove_point(points[i]);
+  test_equal(sharded_hull, dynamic_hull, range);
+}
+
+/* Queries between updates and the next merge answer for the points of the last merge. */
+void test_unmerged(std::vector< Point<int64_t> > const& points, int32_t n_shards, int64_t range) {
+  ShardedDynamicHull< int64_t > sharded_hull(n_shards);
+  size_t half = points.size() / 2;
+  sharded_hull.apply_batch(std::span< Point<int64_t> const >(points.data(), half), {});
+  DynamicHull< int64_t > merged(points.begin(), points.begin() + half);
+
+  for(size_t i = half; i < points.size(); i++) sharded_hull.add_point(points[i]);
+  for(size_t i = 0; i < half; i += 3) sharded_hull.remove_point(points[i]);
+  sharded_hull.add_point(Point<int64_t>(-range, -range)), sharded_hull.add_point(Point<int64_t>(2 * range, 2 * range));
+  assert(not sharded_hull.is_merged());
+  assert(chain_of(sharded_hull, true) == chain_of(merged, true) and chain_of(sharded_hull, false) == chain_of(merged, false));
+  for(int64_t x = -range / 4; x <= range + range / 4; x += std::max< int64_t >(1, range / 8)) {
+    Point<int64_t> point(x, x / 2 - range / 8);
+    assert(sharded_hull.point_in_polygon(point) == merged.point_in_polygon(point));
+    assert(sharded_hull.get_tangents(point) == merged.get_tangents(point));
+  }
+
+  sharded_hull.merge();
+  assert(sharded_hull.is_merged());
+  DynamicHull< int64_t > dynamic_hull(points.begin(), points.end());
+  for(size_t i = 0; i < half; i += 3) dynamic_hull.remove_point(points[i]);
+  dynamic_hull.add_point(Point<int64_t>(-range, -range)), dynamic_hull.add_point(Point<int64_t>(2 * range, 2 * range));
+  test_equal(sharded_hull, dynamic_hull, range);
+}
+
+int main() {
+  std::default_random_engine random_engine;
+
+  for(int32_t n_shards: { 1, 3, 8 }) {
+    std::cout << "shards: " << n_shards << std::endl;
+    for(auto [range, n_points]: { std::pair(8, 40), std::pair(1000, 300), std::pair(1000000, 1000) }) {
+      std::uniform_int_distribution< int64_t > coordinate(0, range);
+      std::vector< Point<int64_t> > points;
+      for(int i = 0; i < n_points; i++) points.emplace_back(coordinate(random_engine), coordinate(random_engine));
+      std::sort(points.begin(), points.end());
+      points.erase(std::unique(points.begin(), points.end()), points.end());
+      std::shuffle(points.begin(), points.end(), random_engine);
+      test_updates(points, n_shards, range);
+      test_batches(points, n_shards, range);
+      test_threads(points, n_shards, range);
+      test_unmerged(points, n_shards, range);
+    }
+
+    // points on a circle, all on the hull, and a stream drifting to the right past every boundary
+    auto circle = random_circle_int_test<int64_t>(2000, 1 << 20);
+    std::sort(circle.begin(), circle.end());
+    circle.erase(std::unique(circle.begin(), circle.end()), circle.end());
+    std::shuffle(circle.begin(), circle.end(), random_engine);
+    test_batches(circle, n_shards, 1 << 21);
+    test_updates(std::vector< Point<int64_t> >(circle.begin(), circle.begin() + 300), n_shards, 1 << 21);
+
+    std::uniform_int_distribution< int64_t > noise(-50, 50);
+    std::vector< Point<int64_t> > drifting;
+    for(int i = 0; i < 2000; i++) drifting.emplace_back(8 * i + noise(random_engine), noise(random_engine) + i % 7);
+    std::sort(drifting.begin(), drifting.end());
+    drifting.erase(std::unique(drifting.begin(), drifting.end()), drifting.end());
+    test_batches(drifting, n_shards, 16000);
+  }
+
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * Validating the sliding window hull against the static ConvexHull of the
+ * points in the window and the gold standard set in util/Tangent.hh.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/Tangent.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/dynamic/SlidingWindowHull.hh>
+
+#include <cmath>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <cassert>
+#include <functional>
+#include <algorithm>
+
+using namespace dpch;
+
+/* Queries at random points, at points of the window, on and off the hull. */
+void test_queries(SlidingWindowHull<int64_t> const& window_hull,
+    std::deque< Point<int64_t> > const& window, int64_t range) {
+  static std::default_random_engine random_engine;
+  std::uniform_int_distribution< int64_t > coordinate(-range / 4, range + range / 4);
+
+  std::vector< Point<int64_t> > points(window.begin(), window.end());
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  auto [lower_chain, upper_chain] = convex_hull(points, true);
+  std::vector< Point<int64_t> > polygon(lower_chain.begin(), lower_chain.end() - 1);
+  polygon.insert(polygon.end(), upper_chain.rbegin(), upper_chain.rend() - 1);
+
+  std::vector< Point<int64_t> > queries(window.begin(), window.begin() + std::min< size_t >(window.size(), 8));
+  for(int i = 0; i < 8; i++) queries.emplace_back(coordinate(random_engine), coordinate(random_engine));
+
+  for(auto const& point: queries) {
+    bool inside = polygon.size() >= 3;
+    for(size_t i = 0, j = polygon.size() - 1; i < polygon.size() and inside; j = i++)
+      inside = (polygon[i] - polygon[j]) * (point - polygon[j]) > 0;
+    assert(window_hull.point_in_polygon(point) == inside);
+
+    auto test_tangents = window_hull.get_tangents(point);
+    assert((test_tangents == std::nullopt) == inside);
+    if( polygon.size() < 3 ) continue;
+    auto [outside, tangents] = get_tangents(point, polygon);
+    if( outside ) assert(tangents == *test_tangents);
+  }
+
+  if( polygon.size() < 3 ) return;
+  static int const n_directions = 64;
+  static double const omega = 2 * acos(-1) / n_directions;
+  for(int i = 0; i < n_directions; i++) {
+    auto direction = Point< int64_t >( 1000000 * cos(i * omega), 1000000 * sin(i * omega) );
+    assert(get_extreme_points(direction, polygon) == window_hull.get_extremal_points(direction));
+  }
+}
+
+/* A stream through a window of the given capacity, checked every so many samples. */
+void test_stream(std::function< Point<int64_t>(int) > const& sample, int64_t range,
+    int capacity, int n_samples, int period) {
+  SlidingWindowHull< int64_t > window_hull(capacity);
+  std::deque< Point<int64_t> > window;
+  for(int i = 0; i < n_samples; i++) {
+    auto point = sample(i);
+    window_hull.add_point(point);
+    window.push_back(point);
+    if( (int)window.size() > capacity ) window.pop_front();
+
+    assert(window_hull.get_num_points() == (int)window.size());
+    assert(window_hull.get_oldest_point() == window.front());
+    if( i % period == 0 ) test_queries(window_hull, window, range);
+  }
+
+  while( not window.empty() ) {
+    assert(window_hull.get_oldest_point() == window.front());
+    test_queries(window_hull, window, range);
+    window_hull.remove_oldest_point(), window.pop_front();
+  }
+  assert(window_hull.get_num_points() == 0);
+}
+
+int main() {
+  std::default_random_engine random_engine;
+
+  for(auto [range, capacity, period]: { std::tuple(8, 1, 1), std::tuple(8, 2, 1), std::tuple(8, 5, 1),
+      std::tuple(32, 40, 1), std::tuple(1000, 100, 3), std::tuple(1000000, 1000, 50) }) {
+    std::cout << "random stream in a window of " << std::setw(6) << capacity << " points" << std::endl;
+    std::uniform_int_distribution< int64_t > coordinate(0, range);
+    test_stream([&](int) { return Point<int64_t>(coordinate(random_engine), coordinate(random_engine)); },
+        range, capacity, 20 * capacity + 100, period);
+  }
+
+  // telemetry: a trend over time with noise, so that the two stacks hardly overlap
+  for(int capacity: { 10, 500 }) {
+    std::cout << "drifting stream in a window of " << std::setw(6) << capacity << " points" << std::endl;
+    std::uniform_int_distribution< int64_t > noise(-50, 50);
+    int64_t range = 40 * capacity + 200;
+    test_stream([&](int i) { return Point<int64_t>(2 * i + noise(random_engine), i + noise(random_engine)); },
+        range, capacity, 20 * capacity, std::max(1, capacity / 50));
+  }
+
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * Validating the workload streams: reproducibility, deletions of live points
+ * only, the size of the live set, and the shape of each distribution, and a
+ * streamed workload through the dynamic hull against the static ConvexHull.
+ */
+#include <dpch/util/Point.hh>
+#include <dpch/util/LineSegment.hh>
+#include <dpch/util/WorkloadGenerator.hh>
+#include <dpch/static/ConvexHull.hh>
+#include <dpch/dynamic/DynamicHull.hh>
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cassert>
+#include <algorithm>
+
+using namespace dpch;
+
+/* Replays the stream twice, checking that it repeats itself and only deletes live points.
+ * Deleting more often than inserting keeps the live set close to lag + block_size. */
+template<typename Distribution> void test_stream(Workload<int64_t, Distribution> workload,
+    double fraction, uint64_t lag, uint64_t block_size) {
+  std::vector< Operation<int64_t> > first;
+  for(auto const& operation: workload) first.push_back(operation);
+  assert(first.size() == workload.get_num_ops());
+
+  std::map< Point<int64_t>, int > live;
+  uint64_t n_live = 0, n_removals = 0, i = 0;
+  for(auto const& operation: workload) {
+    assert(operation.kind == first[i].kind and operation.point == first[i].point), i++;
+    if( operation.kind == Operation<int64_t>::insert ) live[operation.point]++, n_live++;
+    else {
+      assert(live[operation.point] > 0);
+      live[operation.point]--, n_live--, n_removals++;
+      assert(n_live >= lag);
+    }
+    assert(n_live == workload.get_num_live());
+  }
+  assert((n_removals > 0) == (fraction > 0));
+  if( fraction > 0.6 ) assert(n_live <= lag + 2 * block_size + 64);
+}
+
+int main() {
+  uint64_t n_ops = 20000;
+
+  std::cout << "streams" << std::endl;
+  for(auto [fraction, lag, block_size]: { std::tuple(0.0, 0, 1), std::tuple(0.5, 0, 1), std::tuple(0.5, 100, 1),
+      std::tuple(0.5, 100, 64), std::tuple(0.3, 1000, 37), std::tuple(0.7, 300, 7), std::tuple(0.9, 10, 1000) }) {
+    test_stream(Workload<int64_t, UniformSquare<int64_t>>({}, n_ops, 7, fraction, lag, block_size), fraction, lag, block_size);
+    test_stream(Workload<int64_t, Duplicates<int64_t>>({16}, n_ops, 7, fraction, lag, block_size), fraction, lag, block_size);
+    test_stream(Workload<int64_t, Drifting<int64_t>>({{1000}, 2, 1}, n_ops, 7, fraction, lag, block_size), fraction, lag, block_size);
+  }
+
+  std::cout << "distributions" << std::endl;
+  {
+    // other seeds give other points, and the same seed the same ones
+    Workload<int64_t, UniformSquare<int64_t>> a({}, n_ops, 1), b({}, n_ops, 2), c({}, n_ops, 1);
+    assert(a.take(100) == c.take(100) and not (a.take(100) == b.take(100)));
+  }
+  {
+    auto points = Workload<int64_t, Parabola<int64_t>>({}, n_ops).take(n_ops);
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    auto [lower_chain, upper_chain] = convex_hull(points, true);
+    assert(lower_chain.size() == points.size());
+  }
+  {
+    // the default range is clamped for int32_t, whose x^2 would overflow
+    for(auto point: Workload<int32_t, Parabola<int32_t>>({}, n_ops).take(n_ops))
+      assert(point.x >= -46340 and point.x <= 46340 and point.y == point.x * point.x);
+  }
+  {
+    auto points = Workload<int64_t, Duplicates<int64_t>>({50}, n_ops).take(n_ops);
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    assert(points.size() <= 50 and points.size() >= 40);
+  }
+  {
+    GaussianClusters<int64_t> clusters{4, 1000000, 100, 3};
+    auto points = Workload<int64_t, GaussianClusters<int64_t>>(clusters, n_ops).take(n_ops);
+    std::vector< Point<int64_t> > centers;
+    for(uint64_t c = 0; c < 4; c++) {
+      WorkloadRandom center(3, c);
+      int64_t x = center.uniform(0, 1000000), y = center.uniform(0, 1000000);
+      centers.emplace_back(x, y);
+    }
+    int far = 0;
+    for(auto const& point: points) {
+      int64_t nearest = INT64_MAX;
+      for(auto const& center: centers) nearest = std::min(nearest, (point - center) ^ (point - center));
+      far += nearest > 25 * 100 * 100;
+    }
+    assert(far < int(n_ops / 100));
+  }
+  {
+    NearCollinear<int64_t> runs{1000, 1000000, 2, 5};
+    auto points = Workload<int64_t, NearCollinear<int64_t>>(runs, n_ops).take(n_ops);
+    for(uint64_t i = 0; i < n_ops; i++) {
+      WorkloadRandom line(5, i / 1000);
+      int64_t ux = line.uniform(0, 1000000), uy = line.uniform(0, 1000000);
+      int64_t vx = line.uniform(0, 1000000), vy = line.uniform(0, 1000000);
+      Point<int64_t> u(ux, uy), v(vx, vy);
+      double length = std::sqrt(double((v - u) ^ (v - u)));
+      assert(std::abs(double(orientation(u, v, points[i]))) <= 4 * length + 1);
+    }
+  }
+  {
+    auto points = Workload<int64_t, Drifting<int64_t>>({{1000}, 10, 0}, n_ops).take(n_ops);
+    for(uint64_t i = 0; i < n_ops; i++) assert(points[i].x >= int64_t(10 * i) and points[i].x <= int64_t(10 * i + 1000));
+  }
+
+  std::cout << "dynamic hull" << std::endl;
+  {
+    Workload<int64_t, Drifting<int64_t>> workload({{100000}, 5, 3}, n_ops, 11, 0.45, 500, 16);
+    DynamicHull< int64_t > dynamic_hull;
+    std::map< Point<int64_t>, int > live;
+    uint64_t i = 0;
+    for(auto const& operation: workload) {
+      if( operation.kind == Operation<int64_t>::insert ) {
+        if( live[operation.point]++ == 0 ) dynamic_hull.add_point(operation.point);
+      } else if( --live[operation.point] == 0 ) dynamic_hull.remove_point(operation.point);
+
+      if( i++ % 500 != 0 ) continue;
+      std::vector< Point<int64_t> > points;
+      for(auto const& [point, count]: live) if( count > 0 ) points.push_back(point);
+      if( points.size() < 3 ) continue;
+      auto [lower_chain, upper_chain] = convex_hull(points, true);
+      auto lower_iterator = lower_chain.begin();
+      dynamic_hull.traverse_lower_hull([&](LineSegment<int64_t> const& seg) { assert(seg.u == *lower_iterator++); });
+      assert(dynamic_hull.get_hull_size() == int32_t(lower_chain.size() + upper_chain.size() - 2));
+    }
+  }
+
+  std::cout << "all tests passed" << std::endl;
+  return 0;
+}